@@ -7,7 +7,7 @@
 
 // Target Platform: EK-TM4C123GXL Evaluation Board
 // Target uC:       TM4C123GH6PM
-// System Clock:    40 MHz
+// System Clock:    80 MHz
 
 // Hardware configuration:
 // UART Interface:
@@ -15,7 +15,10 @@
 //   The USB on the 2nd controller enumerates to an ICDI interface and a
 //   virtual COM port. Configured to 115,200 baud, 8N1
 // Fault triggers:
-//   PBs
+//   PBs (button.h), the buttons task turns each press into a trig
+// Shell:
+//   runs as an unprivileged task, everything the kernel owns is reached
+//   through the sys* calls in syscall.h
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 // Device includes, defines, and assembler directives
@@ -33,36 +36,37 @@
 #include "gpio.h"
 #include "mem.h"
 #include "mpu.h"
-
-// Info that can be accepted
-#define MAX_CHARS 80
-#define MAX_FIELDS 5
-#define longestCommand 7
-
-// UI info structure
-typedef struct _USER_DATA
-{
-    char buffer[MAX_CHARS+1];
-    uint8_t fieldCount;
-    uint8_t fieldPosition[MAX_FIELDS];
-    char fieldType[MAX_FIELDS];
-} USER_DATA;
-
-// LED bitbands
-    #define BLUE_LED   PORTF,2 // on-board blue LED
-    #define RED_LED    PORTE,0 // off-board red LED
-    #define ORANGE_LED PORTA,2 // off-board orange LED
-    #define YELLOW_LED PORTA,3 // off-board yellow LED
-    #define GREEN_LED  PORTA,4 // off-board green LED
-
-// PB bitbands
-    #define BUS_PB     PORTF,3 // PB0
-    #define USG_PB     PORTC,4 // PB1
-    #define HRD_PB     PORTC,5 // PB2
-    #define MPU_PB     PORTC,6 // PB3
-    #define PSV_PB     PORTC,7 // PB4
-
-uint32_t pid = 12;
+#include "telemetry.h"
+#include "kernel.h"
+#include "syscall.h"
+#include "shell.h"
+#include "crash.h"
+#include "button.h"
+#include "board.h"
+#include "timebase.h"
+#include "profile.h"
+#include "latency.h"
+
+#define SHELL_STACK      2048
+#define SHELL_PRIORITY   8
+#define SHELL_HEAP_QUOTA 16     // blocks, enough for test1 and test2
+
+#define BUTTON_STACK     1024
+#define BUTTON_PRIORITY  4      // sleeps in the kernel until a button moves
+
+#define LATENCY_STACK    1024
+#define LATENCY_PRIORITY 1      // above everything, its wake up is what is measured
+#define LOAD_STACK       1024
+#define LOAD_PRIORITY    12     // below the shell, soaks up what is left during a run
+#define LOAD_HEAP_QUOTA  1
+#define LOAD_BYTES       1024
+#define LOAD_IDLE_MS     100    // between the shell's checks for the end of a run
+#define LOAD_DOT_ROUNDS  64     // malloc and free rounds per '.' printed
+
+#define GROW_STACK       1024   // starts at one block
+#define GROW_LIMIT       3072
+#define GROW_PRIORITY    6      // above the shell, done before its prompt
+#define GROW_DEPTH       26     // calls of 70-100 bytes, past the first two blocks
 
 //-----------------------------------------------------------------------------
 // Subroutines
@@ -71,29 +75,23 @@ uint32_t pid = 12;
 // Initialize Hardware
 void initHw()
 {
-    // Initialize system clock to 40 MHz
-    initSystemClockTo40Mhz();
+    // 64 bit time base first, it follows every clock change from here on
+    initTimeBase();
 
-    // Enable clocks
-    enablePort(PORTF);
-    _delay_cycles(3);
-//
-//    // Configure LED pins
-        selectPinPushPullOutput(BLUE_LED);
+    // Initialize system clock, 80 MHz from the PLL
+    setSystemClock(BOOT_CLOCK);
 
-    // Enable Ports
-    enablePort(PORTA); enablePort(PORTC); enablePort(PORTE);
+    // LEDs and push buttons, the whole pin table at once (board.c)
+    applyPinConfig(boardPins, boardPinCount);
+
+    // Push buttons, interrupt driven with a timer debounce
+    initButtons();
 
     // Enable fault interrupts
     NVIC_SYS_HND_CTRL_R |= NVIC_SYS_HND_CTRL_USAGE | NVIC_SYS_HND_CTRL_BUS | NVIC_SYS_HND_CTRL_MEM;
 
 }
 
-void yield(void)
-{
-    // empty for now (?)
-}
-
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 // Command Processing Functions
 //------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -103,14 +101,9 @@ void getsUart0(USER_DATA *data)
     int count = 0;
     while (count < MAX_CHARS)
     {
-        while (!kbhitUart0())
-        {
-            yield();
-        }
-
-        // get the character input and store in variable
-        char c = getcUart0();
-        putcUart0(c);
+        // get the character input and store in variable, the shell sleeps in the kernel until a key
+        char c = sysGetc();
+        sysPutc(c);
 
         // backspace and not first char
         if ((c == 8 || c == 127) && count > 0)
@@ -243,365 +236,657 @@ bool isCommand(USER_DATA* data, const char strCommand[], uint8_t minArguments)
 
 }
 
+// task local number formatting, uitoa and inttohex keep their buffers in OS RAM
+char* decString(uint32_t num, char str[11])
+{
+    char* ptr = &str[10];
+    *ptr = '\0';
+    do
+    {
+        *(--ptr) = (num % 10) + '0';
+        num /= 10;
+    } while (num != 0);
+    return ptr;
+}
+
+char* hexString(uint32_t num, char str[11])
+{
+    uint8_t i;
+    str[0] = '0';
+    str[1] = 'x';
+    for (i = 0; i < 8; i++)
+        str[9 - i] = "0123456789ABCDEF"[(num >> (i * 4)) & 0xF];
+    str[10] = '\0';
+    return str;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------------------
-// OS Functions
+// Fault Trigger Functions (bus, usage, hard, mpu, pendsv, stack)
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 
-void ps(void)
+void busFaltTrig() // works
 {
-    putsUart0("ps called");
+    // try reading an address with nothing behind it
+    volatile uint32_t* ptr = (uint32_t *) 0x30000000;
+    uint32_t val = *ptr;
+    (void)val;
 }
 
-void ipcs(void)
+void usageFaltTrig()
 {
-    putsUart0("ipcs called");
+    sysTrig(TRIG_USAGE);                 // kernel turns on the divide by 0 trap
+    volatile int zero = 0;               // volatile so the compiler can’t fold it
+    volatile int val = 23 / zero;        // UsageFault now
+    (void)val;
 }
 
-void kill(uint32_t pidK)
+void hardFaltTrig()
 {
-    putsUart0("pid ");
-    putsUart0(uitoa(pidK));
-    putsUart0(" killed");
+    sysTrig(TRIG_HARD);                  // same trap with the usage fault handler disabled
+    volatile int zero = 0;
+    volatile int val = 23 / zero;        // escalates to HardFault
+    (void)val;
 }
-void pkill(char* processName)
+
+void mpuFaltTrig()
 {
-    putsUart0(processName);
-    putsUart0(" killed");
+    // read kernel RAM, closed to every task
+    volatile uint32_t* p = (uint32_t *)0x20000000;
+    uint32_t val = *p;
+    (void)val;
 }
-void pi(bool on)
+
+// recursion that never ends, runs into the guard block below the stack
+uint32_t stackFaltTrig(uint32_t depth)
 {
-    if (on)
-    {
-        putsUart0("pi on");
-    }
-    if (!on)
-    {
-        putsUart0("pi off");
-    }
+    volatile uint32_t frame[16];
+    frame[depth & 15] = depth;
+    return stackFaltTrig(depth + 1) + frame[0];
 }
-void preempt(bool on)
+
+void pendsvTrig()
 {
-    if (on)
-    {
-        putsUart0("preempt on");
-    }
-    if (!on)
+    sysTrig(TRIG_PENDSV);
+}
+
+// the push buttons raise the same faults as trig, a press is one event
+void buttonTask(void)
+{
+    uint8_t event;
+    while (true)
     {
-        putsUart0("preempt off");
+        event = sysButton();
+        if (!(event & BUTTON_PRESSED)) continue;
+        switch (event & BUTTON_NUMBER_M)
+        {
+        case 0: busFaltTrig();   break;
+        case 1: usageFaltTrig(); break;
+        case 2: hardFaltTrig();  break;
+        case 3: mpuFaltTrig();   break;
+        case 4: pendsvTrig();    break;
+        }
     }
 }
-void sched(bool prioOn)  // true = priority scheduling, false = round robin scheduling
+
+// measures its own wake up after every latency timer interrupt (latency.h)
+void latencyTask(void)
 {
-    if (prioOn)
+    uint32_t cycles = LATENCY_NONE;
+    while (true)
     {
-        putsUart0("sched prio");
+        sysLatencyWait(cycles);
+        cycles = latencySince();
     }
-    if (!prioOn)
+}
+
+// background load while a latency run lasts: every malloc and free scans the
+// block table and reprograms the MPU subregions, the dots keep UART0 busy
+void loadTask(void)
+{
+    uint32_t round = 0;
+    uint8_t *p;
+    while (true)
     {
-        putsUart0("sched rr");
+        sysLoadWait();                  // blocked from one run to the next
+        p = sysMalloc(LOAD_BYTES);
+        if (p != NULL)
+        {
+            memset(p, round, LOAD_BYTES);
+            sysFree(p);
+        }
+        if (++round % LOAD_DOT_ROUNDS == 0)
+            sysPutc('.');
     }
 }
-void pidof(char *name)
+
+// one level per yield, every switch lets the kernel grow the stack first
+static uint32_t growDeeper(uint32_t depth)
 {
-    putsUart0(name);
-    putsUart0(" launched");
+    volatile uint8_t frame[64];
+    frame[0] = depth;
+    sysYield();
+    if (depth > 1)
+        return growDeeper(depth - 1) + frame[0];
+    return frame[0];
 }
-void run(char *name)
+
+// opted in to a growing stack (growStack): recurses past its first block and
+// exits, ps shows how far it grew. run grow goes again
+void growTask(void)
 {
-    if (sameStr(name, "blue"))
-        setPinValue(BLUE_LED, 1); // test function turning red led on
+    growDeeper(GROW_DEPTH);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------------------
-// Fault Trigger Functions (bus, usage, hard, mpu, pendsv)
+// Fault Trigger Functions (bus, usage, hard, mpu, pendsv, stack)
 //------------------------------------------------------------------------------------------------------------------------------------------------------
 
-void busFaltTrig() // works
+// the kernel logs the failure itself, the shell runs unprivileged and only says so
+static void mallocCheck(void *p, uint32_t bytes)
 {
-    // try accessing an invalid peripheral address
-    uint32_t* p = malloc_heap(4000);      //fill r1
-    if (!p) putsUart0("malloc failed\n");
+    char str[11];
 
-    uint32_t* s = malloc_heap(8000);      //fill r2
-    if (!s) putsUart0("malloc failed\n");
+    if (p != NULL) return;
+    sysPuts("malloc of ");
+    sysPuts(decString(bytes, str));
+    sysPuts(" bytes failed\n");
+}
 
-    uint32_t* q = malloc_heap(8000);      // fill r3
-    if (!q) putsUart0("malloc failed\n");
+//unpriv r/w pass
+void test1()
+{
+    // malloc stuff, free some of it, the shell is unprivileged so the
+    // block that is still allocated must stay readable and writable
 
-    uint32_t* k = malloc_heap(7000);      // r4
-    if (!k) putsUart0("malloc failed\n");
+    uint32_t* p = sysMalloc(4000);      //fill r1
+    mallocCheck(p, 4000);
 
-    uint32_t* a = malloc_heap(1000);      // r4
-    if (!1) putsUart0("malloc failed\n");
+    uint32_t* s = sysMalloc(8000);      //fill r2
+    mallocCheck(s, 8000);
 
-    free_heap(p);
-    free_heap(s);
-    free_heap(q);
-    free_heap(k);
+    uint32_t* a = sysMalloc(1000);
+    mallocCheck(a, 1000);
 
-    uint32_t* ptr = (uint32_t *) 0xFFFFFFFC;
-    uint32_t val = *ptr;
+    sysFree(p);
+    sysFree(s);
+
+    sysDumpHeap(); // prints the block table
+
+    if (!a) return;
+    *a = 0xB00B;
+    uint32_t val = *a;
+    (void)val;
+    sysPuts("Success!!");
 }
 
-void usageFaltTrig()
+//unpriv r/w fail
+void test2()
 {
-    NVIC_CFG_CTRL_R |= NVIC_CFG_CTRL_DIV0;      // disable the divide by 0 trap
-    volatile int zero = 0;               // volatile so the compiler can’t fold it
-    volatile int val = 23 / zero;        // UsageFault now
+    // malloc stuff
+    // free them
+    // write to them (should fail)
+
+    //In unprivileged mode, dereference the pointer and write to the address (*p = value) and verify there is now a fault.
+
+    uint32_t* p = sysMalloc(4000);      //fill r1
+    mallocCheck(p, 4000);
+
+    uint32_t* k = sysMalloc(7000);
+    mallocCheck(k, 7000);
+
+    uint32_t* a = sysMalloc(1000);
+    mallocCheck(a, 1000);
+
+    sysPuts("malloced heap: \n");
+    sysDumpHeap(); // prints the block table
+
+    sysFree(p);
+    sysFree(k);
+
+    sysPuts("freed heap: \n");
+    sysDumpHeap(); // prints the block table
+
+    *k = 0xB00B;
+    uint32_t val = *k;
     (void)val;
 }
 
-void hardFaltTrig()
+//------------------------------------------------------------------------------------------------------------------------------------------------------
+// Shell Function (mother? mom? mamacita)
+//------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// every command is one line in commandTable, shell() looks the first field up
+// through a case-folded hash instead of trying each name in turn
+typedef void (*COMMAND_HANDLER)(USER_DATA *data);
+
+typedef struct _COMMAND
+{
+    const char *name;
+    uint8_t minArgs;              // arguments after the command name
+    COMMAND_HANDLER handler;
+    const char *help;
+} COMMAND;
+
+#define COMMAND_SLOTS 64          // power of 2, keep at least twice the number of commands
+
+void cmdReboot(USER_DATA *data)
 {
-    NVIC_SYS_HND_CTRL_R &= ~NVIC_SYS_HND_CTRL_USAGE;    // disable usage fault handler
-    usageFaltTrig();
+    sysReboot();
 }
 
-void mpuFaltTrig()
+void cmdPs(USER_DATA *data)
 {
-    setPrivOff();
-    // read from heap without malloc
-    uint32_t* p = (uint32_t *)0x20005000;
+    sysPs();
 }
 
-void pendsvTrig()
+void cmdIpcs(USER_DATA *data)
 {
-    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    sysIpcs();
 }
 
-//------------------------------------------------------------------------------------------------------------------------------------------------------
-// Fault Trigger Functions (bus, usage, hard, mpu, pendsv)
-//------------------------------------------------------------------------------------------------------------------------------------------------------
+void cmdKill(USER_DATA *data)
+{
+    char str[11];
+    uint32_t pidK = getFieldInteger(data, 1);
 
-//unpriv r/w pass
-void test1()
+    sysPuts("pid ");
+    sysPuts(decString(pidK, str));
+    sysPuts(sysKill(pidK) ? " killed" : " not found");
+}
+
+void cmdPkill(USER_DATA *data)
 {
-    // in priv, malloc stuff
-    // witch to unpriv, test to see if you can write to those areas in memory
+    char* processName = getFieldString(data, 1);
 
-    uint32_t* p = malloc_heap(4000);      //fill r1
-    if (!p) putsUart0("malloc failed\n");
+    sysPuts(processName);
+    sysPuts(sysPkill(processName) ? " killed" : " not found");
+}
 
-    uint32_t* s = malloc_heap(8000);      //fill r2
-    if (!s) putsUart0("malloc failed\n");
+void cmdPi(USER_DATA *data)
+{
+    // Turns priority inheritance on or off
+    char* OnOff = getFieldString(data, 1);
 
-    uint32_t* q = malloc_heap(8000);      // fill r3
-    if (!q) putsUart0("malloc failed\n");
+    if (sameStr(OnOff, "on"))
+    {
+        sysPi(true);
+        sysPuts("pi on");
+    }
+    else if (sameStr(OnOff, "off"))
+    {
+        sysPi(false);
+        sysPuts("pi off");
+    }
+    else
+        sysPuts("invalid on|off field");
+}
 
-    uint32_t* k = malloc_heap(7000);      // r4
-    if (!k) putsUart0("malloc failed\n");
+void cmdPreempt(USER_DATA *data)
+{
+    // Turns preemption on or off
+    char* OnOff = getFieldString(data, 1);
 
-    uint32_t* a = malloc_heap(1000);      // very last block
-    if (!a) putsUart0("malloc failed\n");
+    if (sameStr(OnOff, "on"))
+    {
+        sysPreempt(true);
+        sysPuts("preempt on");
+    }
+    else if (sameStr(OnOff, "off"))
+    {
+        sysPreempt(false);
+        sysPuts("preempt off");
+    }
+    else
+        sysPuts("invalid on|off field");
+}
 
-    free_heap(p);
-    free_heap(s);
-    free_heap(q);
-    free_heap(k);
+void cmdSched(USER_DATA *data)
+{
+    // either priority or round robin scheduling
+    char* prioRR = getFieldString(data, 1);
 
-    dumpHeap(); // prints the block table
+    if (sameStr(prioRR, "prio"))
+    {
+        sysSched(true);
+        sysPuts("sched prio");
+    }
+    else if (sameStr(prioRR, "rr"))
+    {
+        sysSched(false);
+        sysPuts("sched rr");
+    }
+    else
+        sysPuts("invalid prio|rr field");
+}
 
-    // Dereference the pointer and write to the address (*p = value)
-    // While in privileged mode, verify you can still access ram in the allocated range of SRAM.
-    setPrivOff();
+void cmdPidof(USER_DATA *data)
+{
+    char str[11];
+    uint32_t pidN = sysPidof(getFieldString(data, 1));
 
-    *a = 0xB00B;
-    uint32_t val = *a;
-    putsUart0("Success!!");
+    if (pidN)
+        sysPuts(decString(pidN, str));
+    else
+        sysPuts("not running");
 }
 
-//unpriv r/w fail
-void test2()
+void cmdRun(USER_DATA *data)
 {
-    // in priv, malloc stuff
-    // free them
-    // switch to unpriv and try to write to them (should fail)
+    char* name = getFieldString(data, 1);
 
-    //In unprivileged mode, dereference the pointer and write to the address (*p = value) and verify there is now a fault.
+    if (sameStr(name, "blue"))
+        PIN_SET(BLUE_LED, 1);     // test function turning blue led on
+    else if (!sysRun(name))
+        sysPuts("nothing to restart");
+}
 
-    uint32_t* p = malloc_heap(4000);      //fill r1
-    if (!p) putsUart0("malloc failed\n");
+void cmdTrig(USER_DATA *data) // trigger fault ISRs
+{
+    char* fault = getFieldString(data, 1);
+    if      (sameStr(fault, "bus"))    busFaltTrig();
+    else if (sameStr(fault, "usage"))  usageFaltTrig();
+    else if (sameStr(fault, "hard"))   hardFaltTrig();
+    else if (sameStr(fault, "mpu"))    mpuFaltTrig();
+    else if (sameStr(fault, "pendsv")) pendsvTrig();
+    else if (sameStr(fault, "stack"))  stackFaltTrig(0);
+    else
+        sysPuts("Invalid. Trigger options: bus, usage, hard, mpu, pendsv, stack");
+}
 
-    uint32_t* s = malloc_heap(8000);      //fill r2
-    if (!s) putsUart0("malloc failed\n");
+void cmdMalloc(USER_DATA *data) // malloc size
+{
+    uint32_t size = atoi(getFieldString(data, 1));
+    data->lastMalloc = sysMalloc(size);
+    if (!data->lastMalloc) sysPuts("invalid\n");
+    else sysPuts("success!\n");
+}
 
-    uint32_t* q = malloc_heap(8000);      // fill r3
-    if (!q) putsUart0("malloc failed\n");
+void cmdDumpHeap(USER_DATA *data)
+{
+    sysDumpHeap();
+}
 
-    uint32_t* k = malloc_heap(7000);      // r4
-    if (!k) putsUart0("malloc failed\n");
+void cmdFree(USER_DATA *data)
+{
+    sysFree(data->lastMalloc);
+    data->lastMalloc = NULL;
+}
 
-    uint32_t* a = malloc_heap(1000);      // very last block
-    if (!a) putsUart0("malloc failed\n");
+void cmdTest1(USER_DATA *data)
+{
+    test1();
+}
 
-    putsUart0("malloced heap: \n");
-    dumpHeap(); // prints the block table
+void cmdTest2(USER_DATA *data)
+{
+    test2();
+}
 
-    free_heap(p);
-    free_heap(s);
-    free_heap(q);
-    free_heap(k);
-//    free_heap(a);
+void cmdTlm(USER_DATA *data) // binary snapshot for tools/telemetry.py
+{
+    char* record = getFieldString(data, 1);
+    if      (sameStr(record, "heap"))  sysTlm(TLM_HEAP);
+    else if (sameStr(record, "mpu"))   sysTlm(TLM_MPU);
+    else if (sameStr(record, "tasks")) sysTlm(TLM_TASKS);
+    else if (sameStr(record, "faults")) sysTlm(TLM_FAULTS);
+    else if (sameStr(record, "profile")) sysTlm(TLM_PROFILE);
+    else if (sameStr(record, "trace")) sysTlm(TLM_TRACE);
+    else if (sameStr(record, "uart"))  sysTlmUart(getFieldInteger(data, 2));
+    else
+        sysPuts("Invalid. Telemetry options: heap, mpu, tasks, faults, profile, trace, uart N");
+}
 
-    putsUart0("freed heap: \n");
-    dumpHeap(); // prints the block table
+void cmdDebugR(USER_DATA *data)
+{
+    char str[11];
+    uint32_t region = atoi(getFieldString(data, 1));
+    sysPuts(hexString(sysMpuRegion(region), str));
+}
 
-    setPrivOff();
+void cmdBench(USER_DATA *data)
+{
+    sysBench();
+}
 
-    *k = 0xB00B;
-    uint32_t val = *k;
+void cmdCrash(USER_DATA *data)
+{
+    sysCrash();
 }
 
-//------------------------------------------------------------------------------------------------------------------------------------------------------
-// Shell Function (mother? mom? mamacita)
-//------------------------------------------------------------------------------------------------------------------------------------------------------
+void cmdFaults(USER_DATA *data)
+{
+    sysFaults();
+}
+
+void cmdClock(USER_DATA *data) // clock profile in MHz or auto, no argument only shows it
+{
+    uint8_t profile = CLOCK_PROFILES;
+    uint32_t mhz, governor;
+    char str[11];
+
+    if (data->fieldCount > 1 && sameStr(getFieldString(data, 1), "auto"))
+        sysGovernor(1);
+    else if (data->fieldCount > 1)
+    {
+        mhz = getFieldInteger(data, 1);
+        for (profile = 0; profile < CLOCK_PROFILES && clockProfileHz((CLOCK_PROFILE)profile) != mhz * 1000000; profile++);
+        if (profile == CLOCK_PROFILES)
+        {
+            sysPuts("Invalid. Clock options: 16, 40, 80, auto");
+            return;
+        }
+    }
+    sysPuts("clock ");
+    sysPuts(decString(sysClock(profile) / 1000000, str));
+    governor = sysGovernor(2);
+    sysPuts(governor >> 8 ? " MHz, governor on, idle " : " MHz, governor off, idle ");
+    sysPuts(decString(governor & 0xFF, str));
+    sysPutc('%');
+}
+
+void cmdProfile(USER_DATA *data) // pc sampling, tlm profile sends the histogram
+{
+    char* action = getFieldString(data, 1);
+
+    if (data->fieldCount == 1)
+        sysProfile(PROFILE_STATUS);
+    else if (sameStr(action, "start"))
+        sysProfile(data->fieldCount > 2 ? getFieldInteger(data, 2) : PROFILE_HZ);
+    else if (sameStr(action, "stop"))
+        sysProfile(0);
+    else
+        sysPuts("Invalid. Profile options: start [HZ], stop");
+}
+
+void cmdTrace(USER_DATA *data) // kernel event trace, tlm trace sends the ring
+{
+    char* action = getFieldString(data, 1);
+
+    if (data->fieldCount == 1)
+        sysTrace(2);
+    else if (sameStr(action, "start"))
+        sysTrace(1);
+    else if (sameStr(action, "stop"))
+        sysTrace(0);
+    else
+        sysPuts("Invalid. Trace options: start, stop");
+}
+
+void cmdLatency(USER_DATA *data) // timer to isr and to task wake up, under load
+{
+    char* action = getFieldString(data, 1);
+
+    if (data->fieldCount == 1)
+        sysLatency(LATENCY_REPORT);
+    else if (sameStr(action, "run"))
+    {
+        if (!sysLatency(data->fieldCount > 2 ? getFieldInteger(data, 2) : LATENCY_SAMPLES))
+            return;
+        while (sysLatency(LATENCY_QUERY))
+            sysSleep(LOAD_IDLE_MS);
+        sysPutc('\n');
+        sysLatency(LATENCY_REPORT);
+    }
+    else
+        sysPuts("Invalid. Latency options: run [N]");
+}
+
+void cmdTime(USER_DATA *data) // uptime straight from the time base, no syscall
+{
+    uint32_t start = timeCycles();
+    uint64_t us = timeUs();
+    uint32_t cycles = timeCycles() - start;
+    uint32_t fraction = us % 1000000;
+    uint32_t digit;
+    char str[11];
+
+    sysPuts("uptime ");
+    sysPuts(decString(us / 1000000, str));
+    sysPutc('.');
+    for (digit = 100000; digit > 1 && fraction < digit; digit /= 10)
+        sysPutc('0');
+    sysPuts(decString(fraction, str));
+    sysPuts(" s, read in ");
+    sysPuts(decString(cycles, str));
+    sysPuts(" cycles at ");
+    sysPuts(decString(timeCyclesPerUs(), str));
+    sysPuts(" MHz");
+}
+
+void cmdHelp(USER_DATA *data);
+
+const COMMAND commandTable[] =
+{
+    {"help",     0, cmdHelp,     "list commands"},
+    {"reboot",   0, cmdReboot,   "restart the system"},
+    {"ps",       0, cmdPs,       "list processes"},
+    {"ipcs",     0, cmdIpcs,     "list inter-process communication objects"},
+    {"kill",     1, cmdKill,     "kill PID"},
+    {"pkill",    1, cmdPkill,    "pkill NAME"},
+    {"pi",       1, cmdPi,       "pi on|off, priority inheritance"},
+    {"preempt",  1, cmdPreempt,  "preempt on|off"},
+    {"sched",    1, cmdSched,    "sched prio|rr"},
+    {"pidof",    1, cmdPidof,    "pidof NAME"},
+    {"run",      1, cmdRun,      "run NAME"},
+    {"trig",     1, cmdTrig,     "trig bus|usage|hard|mpu|pendsv|stack, raise a fault"},
+    {"malloc",   1, cmdMalloc,   "malloc BYTES"},
+    {"dumpHeap", 0, cmdDumpHeap, "print the heap block table"},
+    {"free",     0, cmdFree,     "free the last malloc"},
+    {"test1",    0, cmdTest1,    "unprivileged access to allocated heap (passes)"},
+    {"test2",    0, cmdTest2,    "unprivileged access to freed heap (faults)"},
+    {"tlm",      1, cmdTlm,      "tlm heap|mpu|tasks|faults|profile|trace|uart N, binary telemetry"},
+    {"debugR",   1, cmdDebugR,   "debugR REGION, print MPU_ATTR"},
+    {"bench",    0, cmdBench,    "cycle counts of the allocator, MPU, parser, UART and fault entry"},
+    {"crash",    0, cmdCrash,    "print the record of the last fault reset"},
+    {"faults",   0, cmdFaults,   "fault and pendsv counts, total and per pid"},
+    {"clock",    0, cmdClock,    "clock [16|40|80|auto], core clock in MHz or idle governed"},
+    {"time",     0, cmdTime,     "microseconds since boot, read without a syscall"},
+    {"profile",  0, cmdProfile,  "profile [start [HZ]|stop], pc sampling, tlm profile dumps it"},
+    {"trace",    0, cmdTrace,    "trace [start|stop], kernel events, tlm trace dumps them"},
+    {"latency",  0, cmdLatency,  "latency [run [N]], interrupt and wake up latency under load"}
+};
+
+#define COMMAND_COUNT (sizeof(commandTable) / sizeof(commandTable[0]))
+
+// lives on the shell's stack, the task can't write globals in OS RAM
+typedef struct _COMMAND_INDEX
+{
+    uint32_t hash[COMMAND_COUNT];
+    uint8_t slot[COMMAND_SLOTS];          // command index + 1, 0 = empty
+} COMMAND_INDEX;
+
+void cmdHelp(USER_DATA *data)
+{
+    uint8_t i;
+    for (i = 0; i < COMMAND_COUNT; i++)
+    {
+        sysPuts(commandTable[i].name);
+        sysPuts(" - ");
+        sysPuts(commandTable[i].help);
+        sysPutc('\n');
+    }
+}
+
+// FNV-1a over the lower case string, matches sameStr's case folding
+uint32_t hashCommand(const char *str)
+{
+    uint32_t hash = 2166136261u;
+    while (*str)
+    {
+        char c = *str++;
+        if (c > 64 && c < 91) c += 32;  // if upper case turn lower
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    }
+    return hash;
+}
+
+// builds the open-addressed slot table once when the shell starts
+void initCommandTable(COMMAND_INDEX *index)
+{
+    uint8_t i;
+    memset(index->slot, 0, sizeof(index->slot));
+    for (i = 0; i < COMMAND_COUNT; i++)
+    {
+        uint32_t slot;
+        index->hash[i] = hashCommand(commandTable[i].name);
+        slot = index->hash[i] & (COMMAND_SLOTS - 1);
+        while (index->slot[slot])
+            slot = (slot + 1) & (COMMAND_SLOTS - 1);
+        index->slot[slot] = i + 1;
+    }
+}
+
+// one hash of the field and usually one sameStr, however long the table gets
+const COMMAND* findCommand(const COMMAND_INDEX *index, const char *name)
+{
+    uint32_t hash = hashCommand(name);
+    uint32_t slot = hash & (COMMAND_SLOTS - 1);
+
+    while (index->slot[slot])
+    {
+        uint8_t i = index->slot[slot] - 1;
+        if (index->hash[i] == hash && sameStr(commandTable[i].name, name))
+            return &commandTable[i];
+        slot = (slot + 1) & (COMMAND_SLOTS - 1);
+    }
+    return NULL;
+}
 
 void shell(void)
 {
     USER_DATA data;
+    COMMAND_INDEX index;
+    initCommandTable(&index);
+    data.lastMalloc = NULL;
     while(true)
     {
-        putsUart0("> ");
-        //get string from userCall allowFlashAccess(),
+        sysPuts("> ");
+        //get string from user
         getsUart0(&data);
         //parse fields
         parseFields(&data);
-        //malloc testing
-        uint32_t* p;
 
-        if(isCommand(&data,"reboot",0))
-        {
-            // reboot later
-        }
-        else if(isCommand(&data,"ps",0))
-        {
-            ps();
-        }
-        else if(isCommand(&data,"ipcs",0))
-        {
-            ipcs();
-        }
-        else if(isCommand(&data,"kill",1))
-        {
-            int32_t pidK = getFieldInteger(&data, 1);
-            kill(pidK);
-        }
-        else if(isCommand(&data,"pkill",1))
-        {
-            char* processName = getFieldString(&data, 1);
-            pkill(processName);
-        }
-        else if (isCommand(&data, "pi", 1))
-        {
-            // Turns priority inheritance on or off
-            char* OnOff = getFieldString(&data, 1);
-
-            if (sameStr(OnOff, "on"))
-            {
-                pi(true);
-            }
-            else if (sameStr(OnOff, "off"))
-            {
-                pi(false);
-            }
-            else
-            {
-                putsUart0("invalid on|off field");
-            }
-        }
-        else if (isCommand(&data, "preempt", 1))
-        {
-            // Turns preemption on or off
-            char* OnOff = getFieldString(&data, 1);
-
-            if (sameStr(OnOff, "on"))
-            {
-                preempt(true);
-            }
-            else if (sameStr(OnOff, "off"))
-            {
-                preempt(false);
-            }
-            else
-            {
-                putsUart0("invalid on|off field");
-            }
-        }
-        else if (isCommand(&data, "sched", 1))
-        {
-            // either priority or round robin scheduling
-            char* prioRR = getFieldString(&data, 1);
-            bool prioOn;
-
-            if (sameStr(prioRR, "prio"))
-            {
-                prioOn = true;
-                sched(prioOn);
-            }
-            else if (sameStr(prioRR, "rr"))
-            {
-                prioOn = false;
-                sched(prioOn);
-            }
-            else
-                putsUart0("invalid prio|rr field");
-        }
-        else if (isCommand(&data, "pidof", 1))
+        if (data.fieldCount == 0)
         {
-            char* name = getFieldString(&data, 1);
-            pidof(name);
+            sysPutc('\n');
+            continue;
         }
-        else if (isCommand(&data, "run", 1))
-        {
-            char* name = getFieldString(&data, 1);
-            run(name);
-        }
-        else if (isCommand(&data, "trig", 1)) // trigger fault ISRs
-        {
-            char* fault = getFieldString(&data, 1);
-            if      (sameStr(fault, "bus"))    busFaltTrig();
-            else if (sameStr(fault, "usage"))  usageFaltTrig();
-            else if (sameStr(fault, "hard"))   hardFaltTrig();
-            else if (sameStr(fault, "mpu"))    mpuFaltTrig();
-            else if (sameStr(fault, "pendsv")) pendsvTrig();
-            else
-                putsUart0("Invalid. Trigger options: bus, usage, hard, mpu, pendsv");
-        }
-        else if (isCommand(&data, "malloc", 1)) // malloc size
-        {
-            uint32_t size = atoi(getFieldString(&data, 1));
-            p = malloc_heap(size);
-            if (!p) putsUart0("invalid\n");
-            else putsUart0("success!\n");
-        }
-        else if (isCommand(&data, "dumpHeap", 0))
-        {
-            dumpHeap();
-        }
-        else if (isCommand(&data, "free", 0))
-        {
-            free_heap(p);
-        }
-        else if (isCommand(&data, "test1", 0))
-        {
-            test1();
-        }
-        else if (isCommand(&data, "test2", 0))
+
+        const COMMAND* command = findCommand(&index, getFieldString(&data, 0));
+        if (!command)
         {
-            test2();
+            sysPuts("invalid command");
         }
-        else if (isCommand(&data, "debugR", 1))
+        else if ((data.fieldCount - 1) < command->minArgs)
         {
-            uint32_t region = atoi(getFieldString(&data, 1));
-            NVIC_MPU_NUMBER_R = region;
-            volatile uint32_t regionReg = NVIC_MPU_ATTR_R;
-            putsUart0(inttohex(regionReg));
+            sysPuts("usage: ");
+            sysPuts(command->help);
         }
         else
         {
-            putsUart0("invalid command");
+            command->handler(&data);
         }
-        putcUart0('\n');
+        sysPutc('\n');
     }
 }
 
@@ -613,20 +898,27 @@ int main(void)
 {
     initHw();
     initUart0();
-    setUart0BaudRate(115200, 40e6);
-
-    // process starting at top of heap, decrements
-    setPrivOn();
+    setUart0BaudRate(CONSOLE_BAUD, systemClockHz);
+    faultCheck();           // fault counters survive soft resets only
+    crashCheck();           // one line if a fault reset the system
 
     setBackgroundRule();    // RW for all, X for none
     allowFlashAccess();     // only R for all
     allowPeripheralAccess();// take away RW of priv peripheral from unpriv
     setupSramAccess();      // take away RW from unpriv
+    allowSharedRead(&timeBase, TIME_BASE_SIZE); // R for unpriv, timeUs() without a syscall
 
     NVIC_MPU_CTRL_R |= NVIC_MPU_CTRL_ENABLE | NVIC_MPU_CTRL_PRIVDEFEN;
 
-    setPsp((uint32_t *) 0x20008000);
-    setAspOn();
-
-    shell();
+    // the shell is an ordinary unprivileged process with its own stack in the heap
+    initRtos();
+    createThread(shell, "shell", SHELL_PRIORITY, SHELL_STACK, SHELL_HEAP_QUOTA);
+    respawn("shell");       // an MPU fault kills the shell, a new one takes over
+    createThread(buttonTask, "buttons", BUTTON_PRIORITY, BUTTON_STACK, 0);
+    respawn("buttons");
+    createThread(latencyTask, "latency", LATENCY_PRIORITY, LATENCY_STACK, 0);
+    createThread(loadTask, "load", LOAD_PRIORITY, LOAD_STACK, LOAD_HEAP_QUOTA);
+    createThread(growTask, "grow", GROW_PRIORITY, GROW_STACK, 0);
+    growStack("grow", GROW_LIMIT);   // moves to the top of the heap, grows from there
+    startRtos();
 }
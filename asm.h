@@ -30,5 +30,15 @@ void setAspOn(void);
 void setAspOff(void);
 void setPrivOff(void);
 void setPrivOn(void);
+uint32_t  enterCritical(void);
+void leaveCritical(uint32_t primask);
+uint32_t  syscall(uint32_t number, uint32_t a, uint32_t b, uint32_t c);
+void svcISR(void);
+void pendsvISR(void);
+void busFaultISR(void);
+void usageFaultISR(void);
+void hardFaultISR(void);
+void mpuFaultISR(void);
+void profileISR(void);
 
 #endif
@@ -25,6 +25,23 @@
     .def setAspOff
     .def setPrivOff
     .def setPrivOn
+    .def enterCritical
+    .def leaveCritical
+    .def syscall
+    .def svcISR
+    .def pendsvISR
+    .def busFaultISR
+    .def usageFaultISR
+    .def hardFaultISR
+    .def mpuFaultISR
+    .def profileISR
+    .ref svcCall
+    .ref switchTask
+    .ref busFaultHandler
+    .ref usageFaultHandler
+    .ref hardFaultHandler
+    .ref mpuFaultHandler
+    .ref profileSample
 
 ;-----------------------------------------------------------------------------
 ; Register values and large immediate values
@@ -86,3 +103,90 @@ setPrivOn:
     MSR     CONTROL, r0
     ISB                  ;  instructions that were already fetched or partially executed before are discarded
     BX      lr
+
+enterCritical:          ; returns the old PRIMASK in r0, then masks interrupts
+    MRS     r0, PRIMASK
+    CPSID   I
+    BX      lr
+
+leaveCritical:          ; restores the PRIMASK returned by enterCritical
+    MSR     PRIMASK, r0
+    BX      lr
+
+syscall:                ; unprivileged gate into the kernel, r0 = SVC number, r1-r3 = arguments
+    SVC     #0          ; svcCall leaves the result in the stacked r0
+    BX      lr
+
+svcISR:                 ; only tasks call syscall(), so the exception frame is on the PSP
+    MRS     r0, PSP
+    B       svcCall     ; svcCall(frame) returns straight to the task
+
+pendsvISR:              ; context switch, the hardware already stacked r0-r3, r12, lr, pc, xpsr
+    MRS     r0, PSP
+    TST     lr, #0x10   ; EXC_RETURN bit 4 clear = the task used the FPU, save s16-s31 as well
+    IT      EQ
+    VSTMDBEQ r0!, {s16-s31}
+    STMDB   r0!, {r4-r11, lr}
+    BL      switchTask  ; r0 = sp of the task that stopped, returns the sp of the next one
+    LDMIA   r0!, {r4-r11, lr}
+    TST     lr, #0x10
+    IT      EQ
+    VLDMIAEQ r0!, {s16-s31}
+    MSR     PSP, r0
+    BX      lr          ; EXC_RETURN of the next task unstacks the rest
+
+; fault entries, naked so nothing has touched the stack yet. EXC_RETURN bit 2 says
+; which stack has the exception frame: r0 = frame, r1 = saved r4-r11, r2 = EXC_RETURN.
+; r3 only pads the push to 8 bytes. A handler that returns (bench, MPU kill) comes back
+; through EXC_RETURN like any other exception
+
+busFaultISR:
+    TST     lr, #0x4
+    ITE     EQ
+    MRSEQ   r0, MSP
+    MRSNE   r0, PSP
+    PUSH    {r3-r11, lr}
+    ADD     r1, sp, #4
+    MOV     r2, lr
+    BL      busFaultHandler
+    POP     {r3-r11, pc}
+
+usageFaultISR:
+    TST     lr, #0x4
+    ITE     EQ
+    MRSEQ   r0, MSP
+    MRSNE   r0, PSP
+    PUSH    {r3-r11, lr}
+    ADD     r1, sp, #4
+    MOV     r2, lr
+    BL      usageFaultHandler
+    POP     {r3-r11, pc}
+
+hardFaultISR:
+    TST     lr, #0x4
+    ITE     EQ
+    MRSEQ   r0, MSP
+    MRSNE   r0, PSP
+    PUSH    {r3-r11, lr}
+    ADD     r1, sp, #4
+    MOV     r2, lr
+    BL      hardFaultHandler
+    POP     {r3-r11, pc}
+
+mpuFaultISR:
+    TST     lr, #0x4
+    ITE     EQ
+    MRSEQ   r0, MSP
+    MRSNE   r0, PSP
+    PUSH    {r3-r11, lr}
+    ADD     r1, sp, #4
+    MOV     r2, lr
+    BL      mpuFaultHandler
+    POP     {r3-r11, pc}
+
+profileISR:             ; sample timer, r0 = frame of whatever it interrupted, EXC_RETURN stays in lr
+    TST     lr, #0x4
+    ITE     EQ
+    MRSEQ   r0, MSP
+    MRSNE   r0, PSP
+    B       profileSample
@@ -0,0 +1,321 @@
+// Benchmark Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    80 MHz
+
+// Hardware configuration:
+// DWT:
+//   CYCCNT, enabled by initCycleCounter
+// Benchmarks:
+// runs in the kernel for the shell's bench command (SVC_BENCH). Every sample
+// is timed with CYCCNT minus the cost of reading it, with interrupts masked
+// except for putsUart0 (needs the UART isr) and the fault test (a masked
+// usage fault escalates). Prints min/mean/max cycles of BENCH_RUNS samples
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "tm4c123gh6pm.h"
+#include "asm.h"
+#include "isr.h"
+#include "uart0.h"
+#include "uart.h"
+#include "mem.h"
+#include "mpu.h"
+#include "shell.h"
+#include "kernel.h"
+#include "clock.h"
+#include "bench.h"
+
+#define NAME_WIDTH  24
+#define VALUE_WIDTH 9
+
+typedef struct _BENCH_STAT
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t count;
+    uint32_t fails;         // samples that could not run (malloc returned NULL)
+} BENCH_STAT;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+extern uint64_t srdBitmask;
+
+uint32_t benchOverhead = 0;             // cycles of an empty measurement
+volatile bool benchFaultArmed = false;
+volatile uint32_t benchFaultEntry;      // CYCCNT when usageFaultISR started
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// QEMU counts with the time base, which initTimeBase started
+void initCycleCounter(void)
+{
+#ifndef QEMU_MPS2
+    NVIC_DBG_INT_R |= NVIC_DBG_INT_TRCENA;
+    DWT_CYCCNT_R = 0;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+// called first thing by usageFaultISR, true when the fault was the bench's divide by 0
+bool benchCatchUsageFault(uint32_t entryCycles)
+{
+    if (!benchFaultArmed || !(NVIC_FAULT_STAT_R & NVIC_FAULT_STAT_DIV0)) return false;
+    benchFaultEntry = entryCycles;
+    benchFaultArmed = false;
+    NVIC_CFG_CTRL_R &= ~NVIC_CFG_CTRL_DIV0;     // the divide runs again untrapped and gives 0
+    NVIC_FAULT_STAT_R = NVIC_FAULT_STAT_DIV0;   // write 1 to clear
+    return true;
+}
+
+static void statReset(BENCH_STAT *stat)
+{
+    stat->min = 0xFFFFFFFF;
+    stat->max = 0;
+    stat->total = 0;
+    stat->count = 0;
+    stat->fails = 0;
+}
+
+static void statAdd(BENCH_STAT *stat, uint32_t cycles)
+{
+    cycles -= benchOverhead;
+    if (cycles < stat->min) stat->min = cycles;
+    if (cycles > stat->max) stat->max = cycles;
+    stat->total += cycles;
+    stat->count++;
+}
+
+static void statPrint(const char *name, BENCH_STAT *stat)
+{
+    putsColumn(name, NAME_WIDTH);
+    if (stat->count)
+    {
+        putsRight(uitoa(stat->min), VALUE_WIDTH);
+        putsRight(uitoa(stat->total / stat->count), VALUE_WIDTH);
+        putsRight(uitoa(stat->max), VALUE_WIDTH);
+    }
+    else
+        putsUart0("      n/a");
+    if (stat->fails)
+    {
+        putsUart0("  (");
+        putsUart0(uitoa(stat->fails));
+        putsUart0(" failed)");
+    }
+    putcUart0('\n');
+}
+
+// smallest back to back CYCCNT read, taken off every sample
+static void calibrate(void)
+{
+    uint32_t start, cycles, i;
+    benchOverhead = 0xFFFFFFFF;
+    for (i = 0; i < BENCH_RUNS; i++)
+    {
+        start = DWT_CYCCNT_R;
+        cycles = DWT_CYCCNT_R - start;
+        if (cycles < benchOverhead) benchOverhead = cycles;
+    }
+}
+
+// allocates every free 1 KiB block, returns how many it got
+static uint8_t fillHeap(void *blocks[])
+{
+    uint8_t n = 0;
+    void *p;
+    while (n < NUM_BLOCKS && (p = malloc_heap(BLOCK_SIZE)) != NULL)
+        blocks[n++] = p;
+    return n;
+}
+
+// one malloc and free per sample, the heap pattern decides how far first-fit has to scan
+static void benchMallocFree(const char *mallocName, const char *freeName, uint32_t size)
+{
+    BENCH_STAT mallocStat, freeStat;
+    uint32_t start, mallocCycles, freeCycles, primask, i;
+    void *p;
+
+    statReset(&mallocStat);
+    statReset(&freeStat);
+    for (i = 0; i < BENCH_RUNS; i++)
+    {
+        primask = enterCritical();
+        start = DWT_CYCCNT_R;
+        p = malloc_heap(size);
+        mallocCycles = DWT_CYCCNT_R - start;
+        if (p)
+        {
+            start = DWT_CYCCNT_R;
+            free_heap(p);
+            freeCycles = DWT_CYCCNT_R - start;
+        }
+        leaveCritical(primask);
+
+        statAdd(&mallocStat, mallocCycles);
+        if (p)
+            statAdd(&freeStat, freeCycles);
+        else
+            mallocStat.fails++;
+    }
+    statPrint(mallocName, &mallocStat);
+    if (freeStat.count)
+        statPrint(freeName, &freeStat);
+}
+
+static void benchHeap(void)
+{
+    void *blocks[NUM_BLOCKS];
+    uint8_t n, i;
+
+    // heap as the tasks left it
+    benchMallocFree("malloc 1k", "free 1k", BLOCK_SIZE);
+    benchMallocFree("malloc 8k region", "free 8k region", 8 * BLOCK_SIZE);
+
+    // every block taken, each malloc walks the whole table and fails
+    n = fillHeap(blocks);
+    benchMallocFree("malloc 1k full", "", BLOCK_SIZE);
+
+    // every other block free, 1k takes the first hole, 2k finds no pair and fails
+    for (i = 0; i < n; i += 2)
+        free_heap(blocks[i]);
+    benchMallocFree("malloc 1k checkerboard", "free 1k checkerboard", BLOCK_SIZE);
+    benchMallocFree("malloc 2k checkerboard", "", 2 * BLOCK_SIZE);
+
+    for (i = 1; i < n; i += 2)
+        free_heap(blocks[i]);
+}
+
+static void benchMpu(void)
+{
+    BENCH_STAT stat;
+    uint32_t start, cycles, primask, i;
+
+    statReset(&stat);
+    for (i = 0; i < BENCH_RUNS; i++)
+    {
+        primask = enterCritical();
+        start = DWT_CYCCNT_R;
+        applySramAccessMask(srdBitmask);
+        cycles = DWT_CYCCNT_R - start;
+        leaveCritical(primask);
+        statAdd(&stat, cycles);
+    }
+    statPrint("applySramAccessMask", &stat);
+}
+
+static void benchParse(void)
+{
+    BENCH_STAT stat;
+    USER_DATA data;
+    uint32_t start, cycles, primask, i;
+
+    statReset(&stat);
+    for (i = 0; i < BENCH_RUNS; i++)
+    {
+        strcpy(data.buffer, "trig usage 42 pendsv");
+        primask = enterCritical();
+        start = DWT_CYCCNT_R;
+        parseFields(&data);
+        cycles = DWT_CYCCNT_R - start;
+        leaveCritical(primask);
+        statAdd(&stat, cycles);
+    }
+    statPrint("parseFields 4 fields", &stat);
+}
+
+// blank lines ending in \r so the console is left as it was
+static void benchUart(void)
+{
+    static const char line[] =
+        "                                                               \r";
+    BENCH_STAT stat;
+    uint32_t start, first, cycles, i;
+    uint32_t length = sizeof(line) - 1;
+
+    statReset(&stat);
+    flushUart(&uarts[0]);
+    first = DWT_CYCCNT_R;
+    for (i = 0; i < BENCH_RUNS; i++)
+    {
+        start = DWT_CYCCNT_R;
+        putsUart0((char*)line);
+        cycles = DWT_CYCCNT_R - start;
+        statAdd(&stat, cycles);
+    }
+    flushUart(&uarts[0]);
+    cycles = DWT_CYCCNT_R - first;
+    statPrint("putsUart0 64 bytes", &stat);
+
+    putsColumn("putsUart0 bytes/s", NAME_WIDTH);
+    putsRight(cycles ? uitoa((uint32_t)((uint64_t)length * BENCH_RUNS * systemClockHz / cycles)) : "n/a", VALUE_WIDTH);
+    putcUart0('\n');
+}
+
+// divide by 0 with the trap on, usageFaultISR stamps CYCCNT and returns
+static void benchFault(void)
+{
+    BENCH_STAT entryStat, tripStat;
+    volatile uint32_t zero = 0;
+    volatile uint32_t quotient;
+    uint32_t start, end, i;
+
+    statReset(&entryStat);
+    statReset(&tripStat);
+    for (i = 0; i < BENCH_RUNS; i++)
+    {
+        NVIC_CFG_CTRL_R |= NVIC_CFG_CTRL_DIV0;
+        benchFaultArmed = true;
+        start = DWT_CYCCNT_R;
+        quotient = 1 / zero;
+        end = DWT_CYCCNT_R;
+        if (benchFaultArmed)
+        {
+            benchFaultArmed = false;
+            entryStat.fails++;
+            continue;
+        }
+        statAdd(&entryStat, benchFaultEntry - start);
+        statAdd(&tripStat, end - start);
+    }
+    (void)quotient;
+    statPrint("usage fault entry", &entryStat);
+    statPrint("usage fault round trip", &tripStat);
+}
+
+void bench(void)
+{
+    initCycleCounter();
+    calibrate();
+#ifdef QEMU_MPS2
+    putsUart0("QEMU: cycles are CMSDK Timer 0 counts of the system clock\n");
+#endif
+
+    putsColumn("cycles", NAME_WIDTH);
+    putsRight("min", VALUE_WIDTH);
+    putsRight("mean", VALUE_WIDTH);
+    putsRight("max", VALUE_WIDTH);
+    putcUart0('\n');
+
+    benchHeap();
+    benchMpu();
+    benchParse();
+    benchUart();
+    benchFault();
+}
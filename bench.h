@@ -0,0 +1,50 @@
+// Benchmark Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    80 MHz
+
+// Hardware configuration:
+// DWT:
+//   CYCCNT counts core clocks, privileged only (PPB). QEMU models no DWT,
+//   the time base's CMSDK Timer 0 (qemu/timebase_port.c) counts in its place
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// the device header stops at the NVIC, the DWT is only in the ARM docs
+#ifndef QEMU_MPS2
+#define DWT_CTRL_R              (*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT_R            (*((volatile uint32_t *)0xE0001004))
+#else
+// QEMU models no DWT and bus faults the access. Timer 0 counts the same
+// 25 MHz system clock, timeCycles() reads it as an up count
+#include "timebase.h"
+#define DWT_CYCCNT_R            (timeCycles())
+#endif
+#define DWT_CTRL_CYCCNTENA      0x00000001  // CYCCNT counts
+#define NVIC_DBG_INT_TRCENA     0x01000000  // DEMCR.TRCENA, powers the DWT
+
+#define BENCH_RUNS              32
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initCycleCounter(void);
+bool benchCatchUsageFault(uint32_t entryCycles);
+void bench(void);
+
+#endif
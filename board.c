@@ -0,0 +1,45 @@
+// Board Configuration
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// GPIO:
+//   the pin table initHw hands to applyPinConfig (gpio.c). The UART pins are
+//   set up by the UART driver (uart.c)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "gpio.h"
+#include "button.h"
+#include "board.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+//  port,pin       mode         pull       aux  interrupt
+const PIN_CONFIG boardPins[] =
+{
+    {BLUE_LED,     PIN_OUTPUT,  PULL_NONE, 0,   PIN_INT_NONE},
+    {RED_LED,      PIN_OUTPUT,  PULL_NONE, 0,   PIN_INT_NONE},
+    {ORANGE_LED,   PIN_OUTPUT,  PULL_NONE, 0,   PIN_INT_NONE},
+    {YELLOW_LED,   PIN_OUTPUT,  PULL_NONE, 0,   PIN_INT_NONE},
+    {GREEN_LED,    PIN_OUTPUT,  PULL_NONE, 0,   PIN_INT_NONE},
+    {BUS_PB,       PIN_INPUT,   PULL_UP,   0,   PIN_INT_BOTH},
+    {USG_PB,       PIN_INPUT,   PULL_UP,   0,   PIN_INT_BOTH},
+    {HRD_PB,       PIN_INPUT,   PULL_UP,   0,   PIN_INT_BOTH},
+    {MPU_PB,       PIN_INPUT,   PULL_UP,   0,   PIN_INT_BOTH},
+    {PSV_PB,       PIN_INPUT,   PULL_UP,   0,   PIN_INT_BOTH}
+};
+
+const uint8_t boardPinCount = sizeof(boardPins) / sizeof(boardPins[0]);
@@ -0,0 +1,39 @@
+// Board Configuration
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// LEDs:
+//   blue on-board (PF2), red (PE0), orange (PA2), yellow (PA3), green (PA4)
+// Push Buttons:
+//   see button.h
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef BOARD_H_
+#define BOARD_H_
+
+#include <stdint.h>
+#include "gpio.h"
+
+// LED bitbands
+#define BLUE_LED   PORTF,2 // on-board blue LED
+#define RED_LED    PORTE,0 // off-board red LED
+#define ORANGE_LED PORTA,2 // off-board orange LED
+#define YELLOW_LED PORTA,3 // off-board yellow LED
+#define GREEN_LED  PORTA,4 // off-board green LED
+
+// every GPIO pin of the board, another board variant is another table
+extern const PIN_CONFIG boardPins[];
+extern const uint8_t boardPinCount;
+
+#endif
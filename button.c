@@ -0,0 +1,169 @@
+// Push Button Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Push Buttons:
+//   PB0 on PF3, PB1-PB4 on PC4-PC7, pressed reads 0
+// Debounce Timer:
+//   Timer 1A restarted by every edge, its timeout takes the settled levels
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "gpio.h"
+#include "log.h"
+#include "clock.h"
+#include "button.h"
+#include "kernel.h"
+#include "trace.h"
+
+// register offsets inside a GPIO port block
+#define GPIO_DATA   0x3FC
+#define GPIO_IM     0x410
+#define GPIO_MIS    0x418
+#define GPIO_ICR    0x41C
+
+#define PORT_REG(port, ofs) (*((volatile uint32_t *)(PORT_DATA_BASE(port) + (ofs))))
+
+#define IRQ_GPIOC   (INT_GPIOC - 16)
+#define IRQ_GPIOF   (INT_GPIOF - 16)
+#define IRQ_TIMER1A (INT_TIMER1A - 16)
+
+typedef struct _BUTTON
+{
+    PORT port;
+    uint8_t pin;
+} BUTTON;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const BUTTON buttons[BUTTON_COUNT] = {{BUS_PB}, {USG_PB}, {HRD_PB}, {MPU_PB}, {PSV_PB}};
+
+uint8_t buttonsBouncing = 0;            // masked until the timer, bit per button
+uint8_t buttonsPressed = 0;             // last settled state, bit per button
+
+// written by timer1AIsr only, read by the kernel only
+uint8_t buttonQueue[BUTTON_QUEUE_SIZE];
+volatile uint8_t buttonHead = 0;
+volatile uint8_t buttonTail = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void enableIrq(uint8_t irq)
+{
+    (&NVIC_EN0_R)[irq >> 5] = 1 << (irq & 31);
+}
+
+// the pins (pull-up, both edges) come from the board table, Timer 1A is
+// armed by the first edge
+void initButtons(void)
+{
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R1;
+    _delay_cycles(3);
+    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;
+    TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER1_TAMR_R = TIMER_TAMR_TAMR_1_SHOT;
+    TIMER1_IMR_R = TIMER_IMR_TATOIM;
+
+    enableIrq(IRQ_GPIOC);
+    enableIrq(IRQ_GPIOF);
+    enableIrq(IRQ_TIMER1A);
+}
+
+static void buttonEdge(PORT port)
+{
+    uint32_t mis = PORT_REG(port, GPIO_MIS);
+    uint8_t i;
+
+    PORT_REG(port, GPIO_IM) &= ~mis;    // quiet until the timer looks again
+    PORT_REG(port, GPIO_ICR) = mis;
+    for (i = 0; i < BUTTON_COUNT; i++)
+        if (buttons[i].port == port && (mis & (1 << buttons[i].pin)))
+            buttonsBouncing |= 1 << i;
+
+    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;    // every edge starts the wait over
+    TIMER1_TAILR_R = systemClockHz / 1000 * BUTTON_DEBOUNCE_MS;
+    TIMER1_CTL_R |= TIMER_CTL_TAEN;
+}
+
+void gpioPortCIsr(void)
+{
+    TRACE_POINT(TRACE_ISR_ENTER, INT_GPIOC);
+    buttonEdge(PORTC);
+    TRACE_POINT(TRACE_ISR_EXIT, INT_GPIOC);
+}
+
+void gpioPortFIsr(void)
+{
+    TRACE_POINT(TRACE_ISR_ENTER, INT_GPIOF);
+    buttonEdge(PORTF);
+    TRACE_POINT(TRACE_ISR_EXIT, INT_GPIOF);
+}
+
+static bool buttonDown(uint8_t i)
+{
+    return !((PORT_REG(buttons[i].port, GPIO_DATA) >> buttons[i].pin) & 1);
+}
+
+static void queueEvent(uint8_t event)
+{
+    uint8_t next = (buttonHead + 1) & (BUTTON_QUEUE_SIZE - 1);
+    if (next == buttonTail)
+    {
+        LOG1(LOG_BUTTON_DROP, event);
+        return;
+    }
+    buttonQueue[buttonHead] = event;
+    buttonHead = next;
+}
+
+// bounce is over: one event per button that really changed, then listen again
+void timer1AIsr(void)
+{
+    uint8_t i, bit;
+    bool down;
+
+    TRACE_POINT(TRACE_ISR_ENTER, INT_TIMER1A);
+    TIMER1_ICR_R = TIMER_ICR_TATOCINT;
+    for (i = 0; i < BUTTON_COUNT; i++)
+    {
+        bit = 1 << i;
+        if (!(buttonsBouncing & bit)) continue;
+        PORT_REG(buttons[i].port, GPIO_ICR) = 1 << buttons[i].pin;    // an edge from here on interrupts again
+        down = buttonDown(i);
+        if (down != ((buttonsPressed & bit) != 0))
+        {
+            buttonsPressed ^= bit;
+            queueEvent(i | (down ? BUTTON_PRESSED : 0));
+            wakeWaiting(WAIT_BUTTON);
+        }
+        PORT_REG(buttons[i].port, GPIO_IM) |= 1 << buttons[i].pin;
+    }
+    buttonsBouncing = 0;
+    TRACE_POINT(TRACE_ISR_EXIT, INT_TIMER1A);
+}
+
+// oldest event, false when there is none
+bool getButtonEvent(uint8_t *event)
+{
+    if (buttonHead == buttonTail) return false;
+    *event = buttonQueue[buttonTail];
+    buttonTail = (buttonTail + 1) & (BUTTON_QUEUE_SIZE - 1);
+    return true;
+}
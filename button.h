@@ -0,0 +1,62 @@
+// Push Button Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Push Buttons:
+//   PB0 on PF3, PB1-PB4 on PC4-PC7, to ground, internal pull-ups
+// Debounce Timer:
+//   Timer 1A, one-shot
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef BUTTON_H_
+#define BUTTON_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               BUTTON EVENTS
+ * ==========================================================================
+ *  edge on a pin:   gpioPortxIsr masks that pin and (re)starts Timer 1A
+ *  timer timeout:   timer1AIsr reads the masked pins once they settled,
+ *                   queues an event for each one that changed, wakes a
+ *                   task waiting in sysButton() right away and unmasks
+ *
+ *  nothing runs while no button moves, no delay loop ever waits out bounce
+ */
+
+// PB port,pin pairs (gpio.h)
+#define BUS_PB     PORTF,3 // PB0
+#define USG_PB     PORTC,4 // PB1
+#define HRD_PB     PORTC,5 // PB2
+#define MPU_PB     PORTC,6 // PB3
+#define PSV_PB     PORTC,7 // PB4
+
+#define BUTTON_COUNT        5
+#define BUTTON_DEBOUNCE_MS  20
+#define BUTTON_QUEUE_SIZE   16      // power of 2
+
+// event byte: button number, BUTTON_PRESSED set on press, clear on release
+#define BUTTON_PRESSED      0x80
+#define BUTTON_NUMBER_M     0x7F
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initButtons(void);
+bool getButtonEvent(uint8_t *event);
+
+#endif
@@ -11,26 +11,82 @@
 
 // Hardware configuration:
 // 16 MHz external crystal oscillator
+// PLL through RCC2, 400 MHz output divided down to the system clock
 
 //-----------------------------------------------------------------------------
 // Device includes, defines, and assembler directives
 //-----------------------------------------------------------------------------
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "clock.h"
+#include "timebase.h"
 #include "tm4c123gh6pm.h"
 
+#define PLL_LOCK_TIMEOUT    100000      // polls of PLLSTAT, the PLL needs well under 1 ms
+
+// SYSDIV2 and SYSDIV2LSB as one 7 bit divisor - 1 of the 400 MHz PLL output
+#define SYSDIV400(hz)       ((400000000 / (hz) - 1) << 22)
+
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
 
+static const uint32_t profileHz[CLOCK_PROFILES] = {16000000, 40000000, 80000000};
+
+uint32_t systemClockHz = 16000000;      // PIOSC out of reset
+CLOCK_PROFILE clockProfile = CLOCK_16MHZ;
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
-// Initialize system clock to 40 MHz using PLL and 16 MHz crystal oscillator
-void initSystemClockTo40Mhz(void)
+uint32_t clockProfileHz(CLOCK_PROFILE profile)
+{
+    return profile < CLOCK_PROFILES ? profileHz[profile] : 0;
+}
+
+// Switch the system clock, at boot or at run time. The core runs off the 16 MHz
+// crystal, undivided, while the PLL locks; the divider and the switch to the
+// PLL are one RCC2 write after that. False if the PLL never locks, the core
+// then stays on the crystal and the PLL is powered down again.
+// The caller re-times whatever divides systemClockHz (kernel.c setClockProfile),
+// the time base is rebased here at each rate change. Call initTimeBase first
+bool setSystemClock(CLOCK_PROFILE profile)
 {
-    // Configure HW to work with 16 MHz XTAL, PLL enabled, sysdivider of 5, creating system clock of 40 MHz
-    SYSCTL_RCC_R = SYSCTL_RCC_XTAL_16MHZ | SYSCTL_RCC_OSCSRC_MAIN | SYSCTL_RCC_USESYSDIV | (4 << SYSCTL_RCC_SYSDIV_S);
+    uint32_t timeout = PLL_LOCK_TIMEOUT;
+
+    if (profile >= CLOCK_PROFILES) return false;
+
+    // bypass the PLL: 16 MHz crystal, no divider
+    timeRebase(profileHz[CLOCK_16MHZ]);
+    SYSCTL_RCC_R = SYSCTL_RCC_XTAL_16MHZ | SYSCTL_RCC_OSCSRC_MAIN | SYSCTL_RCC_BYPASS;
+    SYSCTL_RCC2_R = SYSCTL_RCC2_USERCC2 | SYSCTL_RCC2_OSCSRC2_MO | SYSCTL_RCC2_BYPASS2 | SYSCTL_RCC2_USBPWRDN;
+    systemClockHz = profileHz[CLOCK_16MHZ];
+    clockProfile = CLOCK_16MHZ;
+
+    if (profile == CLOCK_16MHZ)
+    {
+        SYSCTL_RCC2_R |= SYSCTL_RCC2_PWRDN2;            // PLL off, it is not needed
+        return true;
+    }
+
+    // PLL on (PWRDN2 clear above), no divider while bypassed
+    while (!(SYSCTL_PLLSTAT_R & SYSCTL_PLLSTAT_LOCK))
+    {
+        if (--timeout == 0)
+        {
+            SYSCTL_RCC_R &= ~SYSCTL_RCC_USESYSDIV;
+            SYSCTL_RCC2_R |= SYSCTL_RCC2_PWRDN2;
+            return false;
+        }
+    }
+
+    // SYSDIV2 is 0 here, /1 of the bypassed crystal, so this alone changes nothing
+    SYSCTL_RCC_R |= SYSCTL_RCC_USESYSDIV;
+    SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~SYSCTL_RCC2_BYPASS2) | SYSCTL_RCC2_DIV400 | SYSDIV400(profileHz[profile]);
+    timeRebase(profileHz[profile]);
+    systemClockHz = profileHz[profile];
+    clockProfile = profile;
+    return true;
 }
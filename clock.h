@@ -19,10 +19,29 @@
 #ifndef CLOCK_H_
 #define CLOCK_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
+// 16 MHz runs straight off the crystal with the PLL powered down, the others
+// divide the 400 MHz PLL output (RCC2 DIV400)
+typedef enum _CLOCK_PROFILE
+{
+    CLOCK_16MHZ,
+    CLOCK_40MHZ,
+    CLOCK_80MHZ,
+    CLOCK_PROFILES
+} CLOCK_PROFILE;
+
+// the one place the core clock is kept, every baud rate, tick and timer
+// divider is computed from it
+extern uint32_t systemClockHz;
+extern CLOCK_PROFILE clockProfile;
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
-void initSystemClockTo40Mhz(void);
+uint32_t clockProfileHz(CLOCK_PROFILE profile);
+bool setSystemClock(CLOCK_PROFILE profile);
 
 #endif
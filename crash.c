@@ -0,0 +1,495 @@
+// Crash Record Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Crash Record:
+//   written by the fault handlers right before a system reset, read back on
+//   the next boot (see crash.h)
+// Fault Counters:
+//   bumped by the handlers in isr.c and by switchTask, sealed by reboot()
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "tm4c123gh6pm.h"
+#include "isr.h"
+#include "uart0.h"
+#include "log.h"
+#include "telemetry.h"
+#include "mem.h"
+#include "kernel.h"
+#include "crash.h"
+
+#define SRAM_START  0x20000000
+#define SRAM_END    0x20008000
+
+#define EXC_RETURN_SPSEL    0x00000004  // frame is on the PSP
+#define XPSR_SPALIGN        0x00000200  // a pad word keeps the frame 8 byte aligned
+#define FLASH_END           0x00040000
+
+#define EXIDX_CANTUNWIND    0x00000001
+#define UNWIND_WORDS        4           // Lu16/Lu32 instruction words followed, GCC needs 1-2
+
+// the registers of the frame being unwound, and the stack it may read
+typedef struct _UNWIND
+{
+    uint32_t r[16];
+    uint32_t low;                       // vsp never goes below, it only unwinds upwards
+    uint32_t top;
+} UNWIND;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+extern uint32_t pid;
+
+// the EHABI index table (.ARM.exidx), weak so a link without one still works
+extern const uint32_t __exidx_start[] __attribute__((weak));
+extern const uint32_t __exidx_end[] __attribute__((weak));
+
+NOINIT CRASH_RECORD crashRecord;
+NOINIT FAULT_COUNTERS faultCounters;
+
+static const char *crashName[] = {"none", "Hard", "MPU", "Bus", "Usage"};
+static const char *countName[] = {"bus", "usage", "hard", "mpu", "pendsv"};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static uint16_t crashCrc(void)
+{
+    return crc16((const uint8_t *)&crashRecord, offsetof(CRASH_RECORD, crc), 0xFFFF);
+}
+
+static bool crashValid(void)
+{
+    return crashRecord.magic == CRASH_MAGIC && crashRecord.type != CRASH_NONE
+        && crashRecord.type <= CRASH_USAGE && crashRecord.crc == crashCrc();
+}
+
+// highest address the stack the frame is on can reach
+static uint32_t stackTop(uint32_t excReturn)
+{
+    if ((excReturn & EXC_RETURN_SPSEL) && taskCurrent != NO_TASK)
+        return (uint32_t)tcb[taskCurrent].stackBase + tcb[taskCurrent].stackSize;
+    return HEAP_START;                      // MSP lives in OS RAM
+}
+
+// address a prel31 word points at, relative to the word itself
+static uint32_t prel31(const uint32_t *word)
+{
+    return (uint32_t)word + ((int32_t)(*word << 1) >> 1);
+}
+
+// index entry of the function holding address, NULL when the table has none
+static const uint32_t *exidxFind(uint32_t address)
+{
+    const uint32_t *first = __exidx_start;
+    uint32_t n = ((uint32_t)__exidx_end - (uint32_t)__exidx_start) / 8;    // two words each
+    uint32_t half;
+
+    if (n == 0 || address < prel31(first)) return NULL;
+    while (n > 1)                           // last entry that starts at or below address
+    {
+        half = n / 2;
+        if (prel31(first + 2 * half) <= address)
+        {
+            first += 2 * half;
+            n -= half;
+        }
+        else
+            n = half;
+    }
+    return first;
+}
+
+// pops the registers in mask (bit n = rn) off the virtual sp, lowest first
+static bool unwindPop(UNWIND *u, uint32_t *vsp, uint32_t mask)
+{
+    uint8_t i;
+    for (i = 0; i < 16; i++)
+    {
+        if (!(mask & (1 << i))) continue;
+        if ((*vsp & 3) || *vsp < u->low || *vsp + 4 > u->top) return false;
+        u->r[i] = *(uint32_t *)*vsp;
+        *vsp += 4;
+    }
+    if (mask & (1 << 13)) *vsp = u->r[13];
+    return true;
+}
+
+// runs the unwind instructions of the function holding address on u, which
+// then holds the caller's registers. False when the function has none, they
+// are not the compact model or they would leave the stack
+static bool unwindFrame(UNWIND *u, uint32_t address)
+{
+    const uint32_t *entry = exidxFind(address), *data;
+    uint8_t code[2 + 4 * UNWIND_WORDS], op, next;
+    uint8_t n = 0, i = 0, w, words, shift;
+    uint32_t vsp = u->r[13], mask, value;
+    bool pcPopped = false;
+
+    if (entry == NULL || entry[1] == EXIDX_CANTUNWIND) return false;
+    data = (entry[1] & 0x80000000) ? &entry[1] : (const uint32_t *)prel31(&entry[1]);
+    if ((uint32_t)data >= FLASH_END || !(data[0] & 0x80000000)) return false;     // personality routines are C++'s
+
+    if ((data[0] & 0x0F000000) == 0)        // Su16: three bytes in this word
+    {
+        code[n++] = data[0] >> 16;
+        code[n++] = data[0] >> 8;
+        code[n++] = data[0];
+    }
+    else if ((data[0] & 0x0F000000) <= 0x02000000)     // Lu16/Lu32: two here, more words after
+    {
+        words = (data[0] >> 16) & 0xFF;
+        if (words > UNWIND_WORDS) return false;
+        code[n++] = data[0] >> 8;
+        code[n++] = data[0];
+        for (w = 1; w <= words; w++)
+            for (shift = 32; shift; )
+            {
+                shift -= 8;
+                code[n++] = data[w] >> shift;
+            }
+    }
+    else
+        return false;
+
+    while (i < n)
+    {
+        op = code[i++];
+        if ((op & 0xC0) == 0x00)            // vsp += (x << 2) + 4
+            vsp += ((op & 0x3F) << 2) + 4;
+        else if ((op & 0xC0) == 0x40)       // vsp -= (x << 2) + 4
+            vsp -= ((op & 0x3F) << 2) + 4;
+        else if ((op & 0xF0) == 0x80)       // pop r4-r15 under a 12 bit mask, 0 refuses
+        {
+            if (i == n) return false;
+            mask = ((op & 0x0F) << 12) | (code[i++] << 4);
+            if (mask == 0 || !unwindPop(u, &vsp, mask)) return false;
+            pcPopped |= (mask >> 15) & 1;
+        }
+        else if ((op & 0xF0) == 0x90)       // vsp = rn
+        {
+            if ((op & 0x0F) == 13 || (op & 0x0F) == 15) return false;
+            vsp = u->r[op & 0x0F];
+        }
+        else if ((op & 0xF0) == 0xA0)       // pop r4-r(4+n), and lr
+        {
+            mask = ((2 << (op & 0x07)) - 1) << 4;
+            if (op & 0x08) mask |= 1 << 14;
+            if (!unwindPop(u, &vsp, mask)) return false;
+        }
+        else if (op == 0xB0)                // finish
+            break;
+        else if (op == 0xB1)                // pop r0-r3 under a mask
+        {
+            if (i == n) return false;
+            mask = code[i++];
+            if (mask == 0 || (mask & 0xF0) || !unwindPop(u, &vsp, mask)) return false;
+        }
+        else if (op == 0xB2)                // vsp += 0x204 + (uleb128 << 2)
+        {
+            value = 0;
+            shift = 0;
+            do
+            {
+                if (i == n || shift > 21) return false;
+                next = code[i++];
+                value |= (uint32_t)(next & 0x7F) << shift;
+                shift += 7;
+            }
+            while (next & 0x80);
+            vsp += 0x204 + (value << 2);
+        }
+        else if (op == 0xB3 || op == 0xC8 || op == 0xC9)   // pop d registers, FSTMFDX adds a word
+        {
+            if (i == n) return false;
+            vsp += ((code[i++] & 0x0F) + 1) * 8 + (op == 0xB3 ? 4 : 0);
+        }
+        else if ((op & 0xF8) == 0xB8)       // pop d8-d(8+n), FSTMFDX
+            vsp += ((op & 0x07) + 1) * 8 + 4;
+        else if ((op & 0xF8) == 0xD0)       // pop d8-d(8+n), VPUSH
+            vsp += ((op & 0x07) + 1) * 8;
+        else
+            return false;                   // iWMMX or spare
+    }
+
+    if (vsp < u->low || vsp > u->top) return false;
+    u->low = u->r[13] = vsp;                // the stack only unwinds upwards
+    if (!pcPopped)
+        u->r[15] = u->r[14];
+    return true;
+}
+
+// the faulting pc, then the return address into each caller the unwind table
+// leads to, up to max. lr stands in for them when the faulting function has
+// no table entry (asm.s, the table left out of the build)
+uint8_t crashBacktrace(uint32_t *frame, uint32_t *regs, uint32_t excReturn, uint32_t *trace, uint8_t max)
+{
+    UNWIND u;
+    uint32_t address = (uint32_t)frame;
+    uint32_t frameWords = (excReturn & EXC_RETURN_BASIC_FRAME) ? FRAME_WORDS : FPU_FRAME_WORDS;
+    uint32_t top = stackTop(excReturn);
+    uint32_t pc = frame[6];
+    uint8_t n = 0, i;
+
+    if ((address & 3) || address < SRAM_START || address + frameWords * 4 > top || top > SRAM_END)
+        return 0;
+    for (i = 0; i < 4; i++)
+        u.r[i] = frame[i];
+    for (i = 0; i < 8; i++)
+        u.r[4 + i] = regs[i];
+    u.r[12] = frame[4];
+    u.r[14] = frame[5];
+    u.r[15] = pc;
+    u.r[13] = address + frameWords * 4 + ((frame[7] & XPSR_SPALIGN) ? 4 : 0);
+    u.low = address;
+    u.top = top;
+
+    trace[n++] = pc;
+    if (!unwindFrame(&u, pc))
+    {
+        if ((frame[5] & 1) && frame[5] < FLASH_END && n < max)
+            trace[n++] = frame[5];
+        return n;
+    }
+    // a return address can be the first word after its function, look up the call
+    while (n < max && (u.r[15] & 1) && u.r[15] < FLASH_END && u.r[15] > 4)
+    {
+        trace[n++] = u.r[15];
+        if (!unwindFrame(&u, (u.r[15] & ~1) - 2)) break;
+    }
+    return n;
+}
+
+void crashPrintBacktrace(uint32_t *frame, uint32_t *regs, uint32_t excReturn)
+{
+    uint32_t trace[CRASH_BACKTRACE];
+    uint8_t n = crashBacktrace(frame, regs, excReturn, trace, CRASH_BACKTRACE);
+    uint8_t i;
+
+    putsUart0("Backtrace:");
+    for (i = 0; i < n; i++)
+    {
+        putcUart0(' ');
+        putsUart0(inttohex(trace[i]));
+    }
+    putcUart0('\n');
+}
+
+// records the fault and resets, nothing here may fault again: the frame is
+// only read when it lies inside SRAM
+void crashReset(CRASH_TYPE type, uint32_t excReturn, uint32_t *frame, uint32_t *regs)
+{
+    uint32_t address = (uint32_t)frame;
+    uint32_t frameWords = (excReturn & EXC_RETURN_BASIC_FRAME) ? FRAME_WORDS : FPU_FRAME_WORDS;
+    uint16_t resets = crashValid() ? crashRecord.resets + 1 : 1;
+    uint8_t i;
+
+    crashRecord.magic = CRASH_MAGIC;
+    crashRecord.type = type;
+    crashRecord.pid = pid;
+    crashRecord.reported = false;
+    crashRecord.cfsr = NVIC_FAULT_STAT_R;
+    crashRecord.hfsr = NVIC_HFAULT_STAT_R;
+    crashRecord.mmfar = NVIC_MM_ADDR_R;
+    crashRecord.bfar = NVIC_FAULT_ADDR_R;
+    crashRecord.excReturn = excReturn;
+    crashRecord.sp = address;
+    crashRecord.stackWords = 0;
+    crashRecord.resets = resets;
+
+    for (i = 0; i < 8; i++)
+    {
+        crashRecord.regs[i] = regs[i];
+        crashRecord.frame[i] = 0;
+    }
+    if (!(address & 3) && address >= SRAM_START && address + FRAME_WORDS * 4 <= SRAM_END)
+    {
+        for (i = 0; i < FRAME_WORDS; i++)
+            crashRecord.frame[i] = frame[i];
+        while (crashRecord.stackWords < CRASH_STACK_WORDS
+               && address + (frameWords + crashRecord.stackWords + 1) * 4 <= SRAM_END)
+        {
+            crashRecord.stack[crashRecord.stackWords] = frame[frameWords + crashRecord.stackWords];
+            crashRecord.stackWords++;
+        }
+    }
+
+    crashRecord.depth = crashBacktrace(frame, regs, excReturn, crashRecord.backtrace, CRASH_BACKTRACE);
+    crashRecord.spare = 0;
+
+    crashRecord.crc = crashCrc();
+    reboot();
+}
+
+// called once from main, before the kernel starts
+// true when the last reset came from a fault handler
+bool crashCheck(void)
+{
+    if (!crashValid() || crashRecord.reported) return false;
+
+    putsUart0("reset by ");
+    putsUart0((char*)crashName[crashRecord.type]);
+    putsUart0(" fault in process ");
+    putsUart0(uitoa(crashRecord.pid));
+    putsUart0(" at pc ");
+    putsUart0(inttohex(crashRecord.frame[6]));
+    putsUart0(", crash for details\n");
+
+    switch (crashRecord.type)
+    {
+    case CRASH_HARD:  LOG3(LOG_HARD_FAULT, crashRecord.pid, crashRecord.frame[6], crashRecord.cfsr & 0xFF); break;
+    case CRASH_MPU:   LOG3(LOG_MPU_FAULT, crashRecord.pid, crashRecord.frame[6], crashRecord.cfsr & 0xFF); break;
+    case CRASH_BUS:   LOG1(LOG_BUS_FAULT, crashRecord.pid); break;
+    case CRASH_USAGE: LOG1(LOG_USAGE_FAULT, crashRecord.pid); break;
+    default: break;
+    }
+
+    crashRecord.reported = true;
+    crashRecord.crc = crashCrc();
+    return true;
+}
+
+static void crashLine(const char *name, uint32_t value)
+{
+    putsUart0((char*)name);
+    putsUart0(inttohex(value));
+    putcUart0('\n');
+}
+
+// the whole record, for the shell's crash command
+void crashPrint(void)
+{
+    static const char *frameName[] = {"R0:         ", "R1:         ", "R2:         ", "R3:         ",
+                                      "R12:        ", "LR:         ", "PC:         ", "xPSR:       "};
+    static const char *regName[] = {"R4:         ", "R5:         ", "R6:         ", "R7:         ",
+                                    "R8:         ", "R9:         ", "R10:        ", "R11:        "};
+    uint8_t i;
+
+    if (!crashValid())
+    {
+        putsUart0("no crash record\n");
+        return;
+    }
+
+    putsUart0((char*)crashName[crashRecord.type]);
+    putsUart0(" fault in process ");
+    putsUart0(uitoa(crashRecord.pid));
+    putsUart0(", fault reset ");
+    putsUart0(uitoa(crashRecord.resets));
+    putsUart0(" since power on\n");
+    crashLine("CFSR:       ", crashRecord.cfsr);
+    crashLine("HFSR:       ", crashRecord.hfsr);
+    if (crashRecord.cfsr & NVIC_FAULT_STAT_MMARV)
+        crashLine("MMFAR:      ", crashRecord.mmfar);
+    if (crashRecord.cfsr & NVIC_FAULT_STAT_BFARV)
+        crashLine("BFAR:       ", crashRecord.bfar);
+    crashLine("EXC_RETURN: ", crashRecord.excReturn);
+    putsUart0((crashRecord.excReturn & EXC_RETURN_SPSEL) ? "PSP:        " : "MSP:        ");
+    putsUart0(inttohex(crashRecord.sp));
+    putcUart0('\n');
+    for (i = 0; i < 8; i++)
+        crashLine(frameName[i], crashRecord.frame[i]);
+    for (i = 0; i < 8; i++)
+        crashLine(regName[i], crashRecord.regs[i]);
+    putsUart0("Backtrace:");
+    for (i = 0; i < crashRecord.depth; i++)
+    {
+        putcUart0(' ');
+        putsUart0(inttohex(crashRecord.backtrace[i]));
+    }
+    putcUart0('\n');
+    putsUart0("Stack:");
+    for (i = 0; i < crashRecord.stackWords; i++)
+    {
+        putcUart0(' ');
+        putsUart0(inttohex(crashRecord.stack[i]));
+    }
+    putcUart0('\n');
+}
+
+static uint16_t faultCrc(void)
+{
+    return crc16((const uint8_t *)&faultCounters, offsetof(FAULT_COUNTERS, crc), 0xFFFF);
+}
+
+// counts for the running pid, from every fault handler and PendSV
+void faultCount(FAULT_COUNT type)
+{
+    FAULT_PID_COUNT *entry = 0;
+    uint8_t i;
+
+    faultCounters.count[type]++;
+    for (i = 0; i < FAULT_PIDS && !entry; i++)
+        if (faultCounters.pids[i].pid == pid)
+            entry = &faultCounters.pids[i];
+    if (!entry)
+    {
+        entry = &faultCounters.pids[faultCounters.next];
+        faultCounters.next = (faultCounters.next + 1) % FAULT_PIDS;
+        entry->pid = pid;
+        for (i = 0; i < COUNT_TYPES; i++)
+            entry->count[i] = 0;
+    }
+    if (entry->count[type] != 0xFFFF)
+        entry->count[type]++;
+}
+
+// reboot() calls it last, the next boot keeps the counters
+void faultSeal(void)
+{
+    faultCounters.crc = faultCrc();
+}
+
+// called once from main, counters that were not sealed start over
+void faultCheck(void)
+{
+    uint8_t i;
+
+    if (faultCounters.magic == FAULT_MAGIC && faultCounters.next < FAULT_PIDS
+        && faultCounters.crc == faultCrc())
+        return;
+    memset(&faultCounters, 0, sizeof(faultCounters));
+    faultCounters.magic = FAULT_MAGIC;
+    for (i = 0; i < FAULT_PIDS; i++)
+        faultCounters.pids[i].pid = FAULT_NO_PID;
+}
+
+// for the shell's faults command, totals first, then per pid
+void faultPrint(void)
+{
+    uint8_t i, t;
+
+    putsColumn("PID", 8);
+    for (t = 0; t < COUNT_TYPES; t++)
+        putsColumn(countName[t], 11);
+    putsUart0("\nall     ");
+    for (t = 0; t < COUNT_TYPES; t++)
+        putsColumn(uitoa(faultCounters.count[t]), 11);
+    putcUart0('\n');
+    for (i = 0; i < FAULT_PIDS; i++)
+    {
+        if (faultCounters.pids[i].pid == FAULT_NO_PID) continue;
+        putsColumn(uitoa(faultCounters.pids[i].pid), 8);
+        for (t = 0; t < COUNT_TYPES; t++)
+            putsColumn(uitoa(faultCounters.pids[i].count[t]), 11);
+        putcUart0('\n');
+    }
+}
@@ -0,0 +1,153 @@
+// Crash Record Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Crash Record:
+//   one record in OS RAM that the C startup does not zero, so it survives the
+//   system reset the fault handlers end with
+// Fault Counters:
+//   next to it, counts of every fault, in total and per pid
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef CRASH_H_
+#define CRASH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               CRASH RECORD
+ * ==========================================================================
+ *  fault handler:  crashReset() fills the record, seals it with crc16
+ *                  (telemetry.h) and requests a system reset
+ *  next boot:      crashCheck() prints a one line notice and logs the fault,
+ *                  once, then service starts as usual
+ *  any time:       the shell's crash command prints the whole record
+ *
+ *  backtrace: unwound with the EHABI index table the compiler emits
+ *  (.ARM.exidx, GCC -funwind-tables, between __exidx_start and __exidx_end).
+ *  From the fault frame and r4-r11 each function's compact unwind
+ *  instructions pop the registers its prologue pushed, which gives the
+ *  caller's sp and return address. It stops at a function without an entry,
+ *  at one it cannot follow or at the top of the stack, so it never reports
+ *  a stale address. tools/backtrace.py symbolizes them
+ *
+ *  power on leaves random RAM behind, magic and crc tell it from a record
+ *
+ * ==========================================================================
+ *               FAULT COUNTERS
+ * ==========================================================================
+ *  every handler in isr.c and every PendSV that finds the MPU DERR or IERR
+ *  bit set counts, in total and for the pid that was running. A plain
+ *  context switch does not. The last FAULT_PIDS pids seen keep their own counts,
+ *  the oldest entry makes room for a new pid. A crc over them every switch
+ *  would cost too much, so reboot() seals them: they carry over fault resets
+ *  and the reboot command, power on and the reset pin start from zero
+ */
+
+// keeps a variable out of the C startup's zero fill
+#if defined(__TI_COMPILER_VERSION__)
+#define NOINIT __attribute__((noinit))
+#else
+#define NOINIT __attribute__((section(".noinit")))
+#endif
+
+#define CRASH_MAGIC         0xC7A5C0DE
+#define CRASH_STACK_WORDS   8
+#define CRASH_BACKTRACE     8       // pc and return addresses kept
+
+#define EXC_RETURN_BASIC_FRAME  0x00000010  // clear when s0-s15 and FPSCR were stacked too
+#define FRAME_WORDS             8
+#define FPU_FRAME_WORDS         26
+
+#define FAULT_MAGIC         0xFA017C75
+#define FAULT_PIDS          8
+#define FAULT_NO_PID        0xFFFF
+
+typedef enum _CRASH_TYPE
+{
+    CRASH_NONE  = 0,
+    CRASH_HARD  = 1,
+    CRASH_MPU   = 2,
+    CRASH_BUS   = 3,
+    CRASH_USAGE = 4
+} CRASH_TYPE;
+
+typedef struct _CRASH_RECORD
+{
+    uint32_t magic;
+    uint8_t  type;                      // CRASH_TYPE
+    uint8_t  pid;
+    uint8_t  stackWords;                // valid words in stack[]
+    uint8_t  reported;                  // boot notice already printed
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uint32_t excReturn;
+    uint32_t sp;                        // address of the exception frame
+    uint32_t frame[8];                  // r0 r1 r2 r3 r12 lr pc xpsr
+    uint32_t regs[8];                   // r4-r11
+    uint32_t stack[CRASH_STACK_WORDS];  // words above the frame (and its FPU part)
+    uint32_t backtrace[CRASH_BACKTRACE];// pc, then the return address into each caller
+    uint8_t  depth;                     // valid entries in backtrace[]
+    uint8_t  spare;
+    uint16_t resets;                    // fault resets since power on
+    uint16_t crc;                       // over everything before it
+} CRASH_RECORD;
+
+typedef enum _FAULT_COUNT
+{
+    COUNT_BUS    = 0,
+    COUNT_USAGE  = 1,
+    COUNT_HARD   = 2,
+    COUNT_MPU    = 3,
+    COUNT_PENDSV = 4,
+    COUNT_TYPES  = 5
+} FAULT_COUNT;
+
+typedef struct _FAULT_PID_COUNT
+{
+    uint16_t pid;                       // FAULT_NO_PID when unused
+    uint16_t count[COUNT_TYPES];        // saturate at 0xFFFF
+} FAULT_PID_COUNT;
+
+typedef struct _FAULT_COUNTERS
+{
+    uint32_t magic;
+    uint32_t count[COUNT_TYPES];        // since power on
+    FAULT_PID_COUNT pids[FAULT_PIDS];
+    uint8_t  next;                      // pids[] entry to reuse next
+    uint8_t  spare;
+    uint16_t crc;                       // over everything before it, see faultSeal
+} FAULT_COUNTERS;
+
+extern FAULT_COUNTERS faultCounters;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint8_t crashBacktrace(uint32_t *frame, uint32_t *regs, uint32_t excReturn, uint32_t *trace, uint8_t max);
+void crashPrintBacktrace(uint32_t *frame, uint32_t *regs, uint32_t excReturn);
+void crashReset(CRASH_TYPE type, uint32_t excReturn, uint32_t *frame, uint32_t *regs);
+bool crashCheck(void);
+void crashPrint(void);
+void faultCount(FAULT_COUNT type);
+void faultSeal(void);
+void faultCheck(void);
+void faultPrint(void);
+
+#endif
@@ -6,7 +6,7 @@
 
 // Target Platform: EK-TM4C123GXL with LCD/Keyboard Interface
 // Target uC:       TM4C123GH6PM
-// System Clock:    40 MHz
+// System Clock:    80 MHz
 
 // Hardware configuration:
 // GPIO APB ports A-F
@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "tm4c123gh6pm.h"
 #include "gpio.h"
 
@@ -36,14 +37,141 @@
 #define OFS_DATA_TO_CR    74*4*8
 #define OFS_DATA_TO_AMSEL 75*4*8
 
+// register offsets inside a GPIO port block, for applyPinConfig
+#define GPIO_DIR    0x400
+#define GPIO_IS     0x404
+#define GPIO_IBE    0x408
+#define GPIO_IEV    0x40C
+#define GPIO_IM     0x410
+#define GPIO_ICR    0x41C
+#define GPIO_AFSEL  0x420
+#define GPIO_ODR    0x50C
+#define GPIO_PUR    0x510
+#define GPIO_PDR    0x514
+#define GPIO_DEN    0x51C
+#define GPIO_LOCK   0x520
+#define GPIO_CR     0x524
+#define GPIO_AMSEL  0x528
+#define GPIO_PCTL   0x52C
+
+#define PORT_COUNT  6
+#define PORT_REG(port, ofs) (*((volatile uint32_t *)(PORT_DATA_BASE(port) + (ofs))))
+
+// what a board table asks of one port
+typedef struct _PORT_CONFIG
+{
+    uint8_t pins;           // pins the table names, nothing else is touched
+    uint8_t dir, odr, pur, pdr, den, amsel, afsel;
+    uint8_t is, ibe, iev, im;
+    uint32_t pctl;
+} PORT_CONFIG;
+
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
 
+static const PORT ports[PORT_COUNT] = {PORTA, PORTB, PORTC, PORTD, PORTE, PORTF};
+static const uint8_t lockedPins[PORT_COUNT] = {0x00, 0x00, 0x00, 0x80, 0x00, 0x01};  // PD7, PF0
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
+// PCTL has 4 bits per pin
+static uint32_t nibbles(uint8_t mask)
+{
+    uint32_t m = 0;
+    uint8_t pin;
+    for (pin = 0; pin < 8; pin++)
+        if (mask & (1 << pin)) m |= 0xFu << (pin * 4);
+    return m;
+}
+
+static uint8_t portIndex(PORT port)
+{
+    uint8_t k;
+    for (k = 0; k < PORT_COUNT - 1 && ports[k] != port; k++);
+    return k;
+}
+
+// collects the whole table first, then one clock write for every port used
+// and one write per register and port
+void applyPinConfig(const PIN_CONFIG pins[], uint8_t count)
+{
+    PORT_CONFIG cfg[PORT_COUNT];
+    PORT_CONFIG *c;
+    uint32_t clocks = 0;
+    uint8_t i, k, bit, mask;
+    PORT port;
+
+    memset(cfg, 0, sizeof(cfg));
+    for (i = 0; i < count; i++)
+    {
+        k = portIndex(pins[i].port);
+        c = &cfg[k];
+        bit = 1 << pins[i].pin;
+        c->pins |= bit;
+        clocks |= 1 << k;
+
+        switch (pins[i].mode)
+        {
+            case PIN_OUTPUT:     c->dir |= bit; c->den |= bit; break;
+            case PIN_OPEN_DRAIN: c->dir |= bit; c->odr |= bit; c->den |= bit; break;
+            case PIN_INPUT:      c->den |= bit; break;
+            case PIN_ANALOG:     c->amsel |= bit; c->afsel |= bit; break;
+            case PIN_AUX:
+                c->den |= bit; c->afsel |= bit;
+                c->pctl |= (uint32_t)(pins[i].aux & 0xF) << (pins[i].pin * 4);
+                break;
+        }
+        if (pins[i].pull == PULL_UP)   c->pur |= bit;
+        if (pins[i].pull == PULL_DOWN) c->pdr |= bit;
+
+        switch (pins[i].intMode)
+        {
+            case PIN_INT_RISING:  c->iev |= bit; c->im |= bit; break;
+            case PIN_INT_FALLING: c->im |= bit; break;
+            case PIN_INT_BOTH:    c->ibe |= bit; c->im |= bit; break;
+            case PIN_INT_HIGH:    c->is |= bit; c->iev |= bit; c->im |= bit; break;
+            case PIN_INT_LOW:     c->is |= bit; c->im |= bit; break;
+        }
+    }
+
+    SYSCTL_GPIOHBCTL_R &= ~clocks;      // APB apertures, the PORTx bit-band addresses
+    SYSCTL_RCGCGPIO_R |= clocks;
+    while ((SYSCTL_PRGPIO_R & clocks) != clocks);
+
+    for (k = 0; k < PORT_COUNT; k++)
+    {
+        c = &cfg[k];
+        mask = c->pins;
+        if (!mask) continue;
+        port = ports[k];
+
+        if (mask & lockedPins[k])
+        {
+            PORT_REG(port, GPIO_LOCK) = GPIO_LOCK_KEY;
+            PORT_REG(port, GPIO_CR) |= mask & lockedPins[k];
+        }
+        PORT_REG(port, GPIO_DIR)   = (PORT_REG(port, GPIO_DIR)   & ~mask) | c->dir;
+        PORT_REG(port, GPIO_ODR)   = (PORT_REG(port, GPIO_ODR)   & ~mask) | c->odr;
+        PORT_REG(port, GPIO_PUR)   = (PORT_REG(port, GPIO_PUR)   & ~mask) | c->pur;
+        PORT_REG(port, GPIO_PDR)   = (PORT_REG(port, GPIO_PDR)   & ~mask) | c->pdr;
+        PORT_REG(port, GPIO_AMSEL) = (PORT_REG(port, GPIO_AMSEL) & ~mask) | c->amsel;
+        PORT_REG(port, GPIO_PCTL)  = (PORT_REG(port, GPIO_PCTL)  & ~nibbles(mask)) | c->pctl;
+        PORT_REG(port, GPIO_AFSEL) = (PORT_REG(port, GPIO_AFSEL) & ~mask) | c->afsel;
+        PORT_REG(port, GPIO_DEN)   = (PORT_REG(port, GPIO_DEN)   & ~mask) | c->den;
+
+        // masked first, the sense is set while they are, edges it made up are cleared
+        PORT_REG(port, GPIO_IM)   &= ~mask;
+        PORT_REG(port, GPIO_IS)    = (PORT_REG(port, GPIO_IS)    & ~mask) | c->is;
+        PORT_REG(port, GPIO_IBE)   = (PORT_REG(port, GPIO_IBE)   & ~mask) | c->ibe;
+        PORT_REG(port, GPIO_IEV)   = (PORT_REG(port, GPIO_IEV)   & ~mask) | c->iev;
+        PORT_REG(port, GPIO_ICR)   = mask;
+        PORT_REG(port, GPIO_IM)    = (PORT_REG(port, GPIO_IM)    & ~mask) | c->im;
+    }
+}
+
 void enablePort(PORT port)
 {
     switch(port)
@@ -347,6 +475,12 @@ void setPortValue(PORT port, uint8_t value)
     }
 }
 
+// only the pins set in mask change, one store through the DATA address mask
+void setPortMasked(PORT port, uint8_t mask, uint8_t value)
+{
+    PORT_MASKED(port, mask) = value;
+}
+
 uint8_t getPortValue(PORT port)
 {
     uint8_t value;
@@ -33,10 +33,73 @@ typedef enum _PORT
     PORTF = 0x42000000 + (0x400253FC-0x40000000)*32
 } PORT;
 
+// Pins known at compile time, written as port,pin pairs (#define BLUE_LED PORTF,2).
+// PIN() is the bit-band word of the pin, so PIN_SET is one store and PIN_GET
+// one load, no call and no address math at run time.
+// PORT_MASKED() is the DATA register seen through the address mask (bits 9:2
+// of the address select the pins), writes change only the pins in the mask.
+// On QEMU the GPIO ports don't exist and the same names call gpio_port.c.
+#ifndef QEMU_MPS2
+#define PIN_WORD(port, pin)             (*((volatile uint32_t *)(port) + (pin)))
+#define PIN(portPin)                    PIN_WORD(portPin)
+#define PIN_SET(portPin, value)         (PIN_WORD(portPin) = (value))
+#define PIN_GET(portPin)                ((bool)PIN_WORD(portPin))
+#define PIN_TOGGLE(portPin)             (PIN_WORD(portPin) ^= 1)
+#define PORT_DATA_BASE(port)            (0x40000000 + ((uint32_t)(port) - 0x42000000) / 32 - 0x3FC)
+#define PORT_MASKED(port, mask)         (*((volatile uint32_t *)(PORT_DATA_BASE(port) + ((mask) << 2))))
+#define PORT_SET_MASKED(port, mask, value) (PORT_MASKED(port, mask) = (value))
+#else
+#define PIN_SET(portPin, value)         setPinValue(portPin, value)
+#define PIN_GET(portPin)                getPinValue(portPin)
+#define PIN_TOGGLE(portPin)             togglePinValue(portPin)
+#define PORT_SET_MASKED(port, mask, value) setPortMasked(port, mask, value)
+#endif
+
+// One line per pin of a board (board.c). applyPinConfig folds the table into
+// per port masks and writes each configuration register of a port once,
+// instead of a read-modify-write per pin and register
+typedef enum _PIN_MODE
+{
+    PIN_INPUT,
+    PIN_OUTPUT,             // push-pull
+    PIN_OPEN_DRAIN,
+    PIN_ANALOG,
+    PIN_AUX                 // PIN_CONFIG.aux is the PCTL function number
+} PIN_MODE;
+
+typedef enum _PIN_PULL
+{
+    PULL_NONE,
+    PULL_UP,
+    PULL_DOWN
+} PIN_PULL;
+
+typedef enum _PIN_INT
+{
+    PIN_INT_NONE,
+    PIN_INT_RISING,
+    PIN_INT_FALLING,
+    PIN_INT_BOTH,
+    PIN_INT_HIGH,
+    PIN_INT_LOW
+} PIN_INT;
+
+typedef struct _PIN_CONFIG
+{
+    PORT port;
+    uint8_t pin;
+    uint8_t mode;           // PIN_MODE
+    uint8_t pull;           // PIN_PULL
+    uint8_t aux;
+    uint8_t intMode;        // PIN_INT, enabled and cleared when not PIN_INT_NONE
+} PIN_CONFIG;
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
+void applyPinConfig(const PIN_CONFIG pins[], uint8_t count);
+
 void enablePort(PORT port);
 void disablePort(PORT port);
 
@@ -66,6 +129,7 @@ void setPinValue(PORT port, uint8_t pin, bool value);
 void togglePinValue(PORT port, uint8_t pin);
 bool getPinValue(PORT port, uint8_t pin);
 void setPortValue(PORT port, uint8_t value);
+void setPortMasked(PORT port, uint8_t mask, uint8_t value);
 uint8_t getPortValue(PORT port);
 
 #endif
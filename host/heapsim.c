@@ -0,0 +1,351 @@
+// Heap and MPU Simulator
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host (make -C host)
+// Target uC:       -
+// System Clock:    -
+
+// Hardware configuration:
+// Simulator:
+//   runs the target's mem.c and mpu.c against the simulated MPU (mpusim.c).
+//   The stress test switches between a few processes the way switchTask does
+//   and does random malloc_heap, free_heap, foreign frees and kills. After
+//   every operation the permission checker asks the simulated MPU about both
+//   ends of every heap block and compares the answers with blockArray. Then
+//   the throughput section times the same calls on the workstation.
+//
+//   heapsim [-n operations] [-s seed]
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tm4c123gh6pm.h"
+#include "mpuhw.h"
+#include "mem.h"
+#include "mpu.h"
+
+#define NUM_PROCS   4
+#define MAX_REPORTS 10
+
+// what the kernel keeps per task, indexed by pid
+typedef struct _SIM_PROC
+{
+    uint64_t srd;
+    void *ptr[NUM_BLOCKS];
+    uint8_t count;
+} SIM_PROC;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+extern uint32_t pid;
+extern uint64_t srdBitmask;
+extern uint64_t logEvents;
+
+SIM_PROC procs[NUM_PROCS + 1];
+uint32_t rngState = 1;
+uint64_t violations = 0;
+volatile uintptr_t sink;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static uint32_t rng(void)
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static double nowNs(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static void violation(const char *what, uint32_t address)
+{
+    if (violations++ < MAX_REPORTS)
+        printf("VIOLATION pid %u: %s at 0x%08X\n", pid, what, address);
+}
+
+static int regionOf(int block)
+{
+    return block < 4 ? 0 : (block - 4) / 8 + 1;
+}
+
+static uint64_t ownedMask(uint32_t owner)
+{
+    uint64_t mask = 0;
+    int i;
+    for (i = 0; i < NUM_BLOCKS; i++)
+        if (blockArray[i].alloc && blockArray[i].owner == owner)
+            mask |= (uint64_t)1 << (i + 4);
+    return mask;
+}
+
+// the same main() does on the target
+static void resetSystem(void)
+{
+    memset(blockArray, 0, sizeof(BLOCK) * NUM_BLOCKS);
+    memset(procs, 0, sizeof(procs));
+    simMpuReset();
+    setBackgroundRule();
+    allowFlashAccess();
+    allowPeripheralAccess();
+    setupSramAccess();
+    NVIC_MPU_CTRL_R |= NVIC_MPU_CTRL_ENABLE | NVIC_MPU_CTRL_PRIVDEFEN;
+    pid = 1;
+    srdBitmask = 0;
+    applySramAccessMask(srdBitmask);
+}
+
+// what switchTask does with the masks
+static void switchTo(uint32_t next)
+{
+    procs[pid].srd = srdBitmask;
+    pid = next;
+    srdBitmask = procs[pid].srd;
+    applySramAccessMask(srdBitmask);
+}
+
+// runs are contiguous, same owner and size, and never cross an MPU region
+static void checkTable(void)
+{
+    int i = 0, k;
+    while (i < NUM_BLOCKS)
+    {
+        if (!blockArray[i].alloc)
+        {
+            if (blockArray[i].owner || blockArray[i].size) violation("free block with owner", HEAP_START + i * BLOCK_SIZE);
+            i++;
+            continue;
+        }
+        int size = blockArray[i].size;
+        if (size == 0 || i + size > NUM_BLOCKS || regionOf(i) != regionOf(i + size - 1))
+        {
+            violation("bad allocation run", HEAP_START + i * BLOCK_SIZE);
+            i++;
+            continue;
+        }
+        for (k = i; k < i + size; k++)
+            if (!blockArray[k].alloc || blockArray[k].owner != blockArray[i].owner || blockArray[k].size != blockArray[i].size)
+                violation("broken allocation run", HEAP_START + k * BLOCK_SIZE);
+        i += size;
+    }
+}
+
+// every saved mask matches the blocks its process owns (bits 4-31 are the heap)
+static void checkMasks(void)
+{
+    uint32_t p;
+    for (p = 1; p <= NUM_PROCS; p++)
+    {
+        uint64_t mask = (p == pid) ? srdBitmask : procs[p].srd;
+        if ((mask & 0xFFFFFFF0) != ownedMask(p))
+            violation("SRD mask out of step with blockArray", p);
+    }
+}
+
+// unprivileged code reaches exactly the blocks the running pid owns, the kernel reaches all of them
+static void checkPermissions(void)
+{
+    int i;
+    for (i = 0; i < NUM_BLOCKS; i++)
+    {
+        uint32_t first = HEAP_START + i * BLOCK_SIZE;
+        uint32_t last = first + BLOCK_SIZE - 4;
+        bool expected = blockArray[i].alloc && blockArray[i].owner == pid;
+
+        if (simMpuAllows(first, false, true) != expected || simMpuAllows(last, false, false) != expected)
+            violation(expected ? "own block denied" : "foreign or free block allowed", first);
+        if (!simMpuAllows(first, true, true))
+            violation("privileged access denied", first);
+    }
+    if (simMpuAllows(0x20000000, false, false) || simMpuAllows(HEAP_START - 4, false, true))
+        violation("OS RAM open to unprivileged code", 0x20000000);
+}
+
+static uint32_t randomSize(void)
+{
+    uint32_t r = rng() % 100;
+    if (r < 70) return 1 + rng() % 2048;
+    if (r < 95) return 1 + rng() % 4096;
+    return 1 + rng() % 8192;
+}
+
+static void stress(uint32_t operations)
+{
+    uint64_t mallocs = 0, mallocFails = 0, frees = 0, rejects = 0, kills = 0, switches = 0, touches = 0;
+    uint64_t accessesBefore = simMpu.accesses;
+    BLOCK before[NUM_BLOCKS];
+    uint32_t seed = rngState;
+    uint32_t n;
+
+    resetSystem();
+    for (n = 0; n < operations; n++)
+    {
+        SIM_PROC *p = &procs[pid];
+        uint32_t r = rng() % 100;
+
+        if (r < 35)
+        {
+            void *ptr = malloc_heap(randomSize());
+            if (ptr)
+            {
+                p->ptr[p->count++] = ptr;
+                mallocs++;
+            }
+            else
+                mallocFails++;
+        }
+        else if (r < 65)
+        {
+            if (p->count)
+            {
+                uint8_t k = rng() % p->count;
+                free_heap(p->ptr[k]);
+                p->ptr[k] = p->ptr[--p->count];
+                frees++;
+            }
+        }
+        else if (r < 72)
+        {
+            // another process's pointer, free_heap has to refuse it
+            uint32_t other = 1 + rng() % NUM_PROCS;
+            if (other != pid && procs[other].count)
+            {
+                memcpy(before, blockArray, sizeof(before));
+                free_heap(procs[other].ptr[rng() % procs[other].count]);
+                if (memcmp(before, blockArray, sizeof(before)) != 0)
+                    violation("foreign free accepted", 0);
+                rejects++;
+            }
+        }
+        else if (r < 74)
+        {
+            free_heap_owner(pid, &srdBitmask);
+            applySramAccessMask(srdBitmask);
+            p->count = 0;
+            kills++;
+        }
+        else if (r < 90)
+        {
+            switchTo(1 + rng() % NUM_PROCS);
+            switches++;
+        }
+        else
+        {
+            // the process uses its memory, both ends of every allocation
+            uint8_t k;
+            for (k = 0; k < p->count; k++)
+            {
+                uint32_t address = SRAM_ADDR(p->ptr[k]);
+                uint32_t blocks = blockArray[(address - HEAP_START) / BLOCK_SIZE].size;
+                if (!simMpuAllows(address, false, true) || !simMpuAllows(address + blocks * BLOCK_SIZE - 4, false, true))
+                    violation("allocation not writable", address);
+            }
+            touches++;
+        }
+
+        checkTable();
+        checkMasks();
+        checkPermissions();
+    }
+
+    printf("stress: %u operations, seed %u\n", operations, seed);
+    printf("  malloc %llu ok %llu failed, free %llu, foreign free %llu, kill %llu, switch %llu, touch %llu\n",
+           (unsigned long long)mallocs, (unsigned long long)mallocFails, (unsigned long long)frees,
+           (unsigned long long)rejects, (unsigned long long)kills, (unsigned long long)switches,
+           (unsigned long long)touches);
+    printf("  %llu simulated accesses checked, %llu log records, %llu violations\n\n",
+           (unsigned long long)(simMpu.accesses - accessesBefore), (unsigned long long)logEvents,
+           (unsigned long long)violations);
+}
+
+static void report(const char *name, uint32_t count, double ns)
+{
+    printf("  %-32s %9.1f ns/op %12.0f ops/s\n", name, ns / count, count * 1e9 / ns);
+}
+
+static void throughput(uint32_t count)
+{
+    void *blocks[NUM_BLOCKS];
+    uint64_t mask = 0;
+    double start;
+    uint32_t i;
+    uint8_t n, k;
+
+    printf("throughput (host, %u iterations)\n", count);
+
+    resetSystem();
+    start = nowNs();
+    for (i = 0; i < count; i++)
+    {
+        void *p = malloc_heap(BLOCK_SIZE);
+        free_heap(p);
+    }
+    report("malloc_heap+free_heap 1k empty", count, nowNs() - start);
+
+    start = nowNs();
+    for (i = 0; i < count; i++)
+    {
+        void *p = malloc_heap(1 + rng() % 8192);
+        if (p) free_heap(p);
+    }
+    report("malloc_heap+free_heap random", count, nowNs() - start);
+
+    // every other block free, 2k never fits and scans the whole table
+    for (n = 0; n < NUM_BLOCKS && (blocks[n] = malloc_heap(BLOCK_SIZE)) != NULL; n++);
+    for (k = 0; k < n; k += 2)
+        free_heap(blocks[k]);
+    start = nowNs();
+    for (i = 0; i < count; i++)
+        sink = (uintptr_t)malloc_heap(2 * BLOCK_SIZE);
+    report("malloc_heap 2k checkerboard fail", count, nowNs() - start);
+
+    start = nowNs();
+    for (i = 0; i < count; i++)
+        applySramAccessMask(srdBitmask ^ (i & 0xF0));
+    report("applySramAccessMask", count, nowNs() - start);
+
+    start = nowNs();
+    for (i = 0; i < count; i++)
+    {
+        mask = 0;
+        addSramAccessWindow(&mask, SRAM_PTR(HEAP_START + (i % 20) * BLOCK_SIZE), 8 * BLOCK_SIZE);
+    }
+    sink = mask;
+    report("addSramAccessWindow 8k", count, nowNs() - start);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t operations = 1000000;
+    int i;
+
+    for (i = 1; i < argc - 1; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0) operations = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-s") == 0) rngState = strtoul(argv[++i], NULL, 0) | 1;
+    }
+
+    stress(operations);
+    throughput(operations);
+    return violations ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+// Simulated MPU
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host (make -C host)
+// Target uC:       -
+// System Clock:    -
+
+// Hardware configuration:
+// MPU:
+//   register file written by mpu.c through mpuhw.h, decoded on every
+//   simulated access the way the Cortex-M4 does it
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "tm4c123gh6pm.h"
+#include "mpusim.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+SIM_MPU simMpu;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simMpuReset(void)
+{
+    memset(&simMpu, 0, sizeof(simMpu));
+}
+
+// MPU_ATTR AP field, see the notes at the end of mpu.c
+static bool apAllows(uint32_t ap, bool privileged, bool write)
+{
+    switch (ap)
+    {
+    case 1:  return privileged;
+    case 2:  return privileged || !write;
+    case 3:  return true;
+    case 5:  return privileged && !write;
+    case 6:
+    case 7:  return !write;
+    default: return false;
+    }
+}
+
+// the highest numbered enabled region that holds the address decides, a disabled
+// subregion hides its region; no match is the background map (privileged + PRIVDEFEN only)
+bool simMpuAllows(uint32_t address, bool privileged, bool write)
+{
+    int region;
+
+    simMpu.accesses++;
+    if (!(simMpu.ctrl & NVIC_MPU_CTRL_ENABLE))
+        return true;
+
+    for (region = 7; region >= 0; region--)
+    {
+        uint32_t attr = simMpu.attr[region];
+        uint64_t size, base, offset;
+
+        if (!(attr & NVIC_MPU_ATTR_ENABLE)) continue;
+        size = (uint64_t)1 << (((attr >> 1) & 0x1F) + 1);
+        base = simMpu.base[region] & 0xFFFFFFE0 & ~(size - 1);
+        offset = (uint64_t)address - base;
+        if ((uint64_t)address < base || offset >= size) continue;
+        if (size >= 256 && ((attr >> 8) & (1 << (offset / (size / 8))))) continue;
+        return apAllows((attr >> 24) & 7, privileged, write);
+    }
+    return privileged && (simMpu.ctrl & NVIC_MPU_CTRL_PRIVDEFEN);
+}
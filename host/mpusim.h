@@ -0,0 +1,55 @@
+// Simulated MPU
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host (make -C host)
+// Target uC:       -
+// System Clock:    -
+
+// Hardware configuration:
+// MPU:
+//   ARMv7-M PMSA model, 8 regions with subregions, background map for
+//   privileged code when PRIVDEFEN is set
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef MPUSIM_H_
+#define MPUSIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct _SIM_MPU
+{
+    uint32_t number;
+    uint32_t ctrl;
+    uint32_t base[8];
+    uint32_t attr[8];
+    uint64_t accesses;      // simMpuAllows calls
+} SIM_MPU;
+
+extern SIM_MPU simMpu;
+
+// mpu.c keeps using the device header names
+#undef NVIC_MPU_NUMBER_R
+#undef NVIC_MPU_BASE_R
+#undef NVIC_MPU_ATTR_R
+#undef NVIC_MPU_CTRL_R
+#define NVIC_MPU_NUMBER_R   (simMpu.number)
+#define NVIC_MPU_BASE_R     (simMpu.base[simMpu.number & 7])
+#define NVIC_MPU_ATTR_R     (simMpu.attr[simMpu.number & 7])
+#define NVIC_MPU_CTRL_R     (simMpu.ctrl)
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simMpuReset(void);
+bool simMpuAllows(uint32_t address, bool privileged, bool write);
+
+#endif
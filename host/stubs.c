@@ -0,0 +1,71 @@
+// Host Stubs
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: Linux host (make -C host)
+// Target uC:       -
+// System Clock:    -
+
+// Hardware configuration:
+// Stubs:
+//   the few target calls mem.c and mpu.c make outside themselves: the
+//   console goes to stdout and log records are only counted
+// SRAM:
+//   hostSram holds 0x20000000-0x20007FFF, mem.h SRAM_PTR/SRAM_ADDR map into it
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "uart0.h"
+#include "isr.h"
+#include "log.h"
+#include "mem.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+uint32_t pid = 1;                       // the kernel's running process
+uint64_t logEvents = 0;
+uint8_t hostSram[HEAP_END - SRAM_BASE] __attribute__((aligned(BLOCK_SIZE)));
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void putcUart0(char c)
+{
+    putchar(c);
+}
+
+void putsUart0(char* str)
+{
+    fputs(str, stdout);
+}
+
+char* uitoa(uint32_t num)
+{
+    static char str[11];
+    snprintf(str, sizeof(str), "%u", num);
+    return str;
+}
+
+char* inttohex(uint32_t num)
+{
+    static char str[11];
+    snprintf(str, sizeof(str), "0x%X", num);
+    return str;
+}
+
+void logEvent(uint32_t header, uint32_t a, uint32_t b, uint32_t c)
+{
+    (void)header; (void)a; (void)b; (void)c;
+    logEvents++;
+}
@@ -10,8 +10,8 @@
 
 // Hardware configuration:
 // Interrupt Handlers:
-// short low cost programs that return information about the system failure
-// when an interrupt is triggered
+// short low cost programs that record the system failure when a fault is
+// triggered and restart the system (crash.c)
 
 //-----------------------------------------------------------------------------
 // Device includes, defines, and assembler directives
@@ -21,10 +21,17 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include "tm4c123gh6pm.h"
 #include "isr.h"
-#include "asm.h"
 #include "uart0.h"
+#include "asm.h"
+#include "bench.h"
+#include "crash.h"
+#include "kernel.h"
+
+#define EXC_RETURN_MODE_M       0x0000000F  // return mode and stack bits
+#define EXC_RETURN_THREAD_PSP   0x0000000D  // thread mode on the PSP
 
 //-----------------------------------------------------------------------------
 // Global variables
@@ -77,114 +84,63 @@ char* inttohex(uint32_t num)
     return ptr;
 }
 
-void busFaultISR()
+// str then spaces out to width, for the shell's tables
+void putsColumn(const char *str, uint8_t width)
 {
-    putsUart0("Bus fault in process "); putsUart0(uitoa(pid)); putcUart0('\n');
-
-    while(1);
+    uint8_t n = strlen(str);
+    putsUart0((char*)str);
+    while (n++ < width)
+        putcUart0(' ');
 }
 
-void usageFaultISR()
+// spaces then str, numbers line up on the right
+void putsRight(const char *str, uint8_t width)
 {
-    putsUart0("Usage fault in process ");
-    putsUart0(uitoa(pid));
-    putcUart0('\n');
+    uint8_t n = strlen(str);
+    while (n++ < width)
+        putcUart0(' ');
+    putsUart0((char*)str);
+}
 
-    while(1);
+// the fault entries in asm.s pass the exception frame from whichever stack
+// was in use, the saved r4-r11 and EXC_RETURN. Every fault that is not
+// handled here ends in a crash record and a system reset (crash.c)
+void busFaultHandler(uint32_t *frame, uint32_t *regs, uint32_t excReturn)
+{
+    faultCount(COUNT_BUS);
+    crashReset(CRASH_BUS, excReturn, frame, regs);
 }
 
-void hardFaultISR()
+void usageFaultHandler(uint32_t *frame, uint32_t *regs, uint32_t excReturn)
 {
-    uint32_t r0, r1, r2, r3, r12, lr, pc, xpsr, mfault, address;
-    uint32_t *psp, *msp;
-
-    // go up the stack to collect values to output
-    psp  = getPsp();
-    msp  = getMsp();
-    r0   = *psp;
-    r1   = *(psp + 1);
-    r2   = *(psp + 2);
-    r3   = *(psp + 3);
-    r12  = *(psp + 4);
-    lr   = *(psp + 5);
-    pc   = *(psp + 6);
-    xpsr = getIpsr();
-    mfault = NVIC_FAULT_STAT_R & 0xFF;       // mem fault  bits [7:0] in FAULTSTAT
-    address = pc;
-    uint32_t opcode = *((uint32_t*)(address));
-
-    putsUart0("Hard fault in process  "); putsUart0(uitoa(pid));                  putcUart0('\n');
-    putsUart0("PSP:                   "); putsUart0(inttohex((uint32_t)psp));        putcUart0('\n');
-    putsUart0("MSP:                   "); putsUart0(inttohex((uint32_t)msp));        putcUart0('\n');
-    putsUart0("MFault Flags:          "); putsUart0(inttohex(mfault));            putcUart0('\n');
-    putsUart0("Offending Instruction: "); putsUart0(inttohex((uint32_t)opcode));  putcUart0('\n');
-    putsUart0("Address of Instruction:"); putsUart0(inttohex(address));              putcUart0('\n');
-    putsUart0("Stack Dump!!");                                                    putcUart0('\n');
-    putsUart0("xPSR:                  "); putsUart0(inttohex(xpsr));                 putcUart0('\n');
-    putsUart0("PC:                    "); putsUart0(inttohex(pc));                   putcUart0('\n');
-    putsUart0("LR:                    "); putsUart0(inttohex(lr));                   putcUart0('\n');
-    putsUart0("R12:                   "); putsUart0(inttohex(r12));                  putcUart0('\n');
-    putsUart0("R3:                    "); putsUart0(inttohex(r3));                   putcUart0('\n');
-    putsUart0("R2:                    "); putsUart0(inttohex(r2));                   putcUart0('\n');
-    putsUart0("R1:                    "); putsUart0(inttohex(r1));                   putcUart0('\n');
-    putsUart0("R0:                    "); putsUart0(inttohex(r0));                   putcUart0('\n');
-
-    while(1);
+    uint32_t entryCycles = DWT_CYCCNT_R;    // first thing, the bench command times fault entry with it
+    if (benchCatchUsageFault(entryCycles))
+        return;
+
+    faultCount(COUNT_USAGE);
+    crashReset(CRASH_USAGE, excReturn, frame, regs);
 }
 
-void mpuFaultISR()
+void hardFaultHandler(uint32_t *frame, uint32_t *regs, uint32_t excReturn)
 {
-    uint32_t r0, r1, r2, r3, r12, lr, pc, xpsr, mfault, address;
-    uint32_t *psp, *msp;
-    //char *instruction;
-
-    // go up the stack to collect values to output
-    psp  = getPsp();
-    msp  = getMsp();
-    r0   = *psp;
-    r1   = *(psp + 1);
-    r2   = *(psp + 2);
-    r3   = *(psp + 3);
-    r12  = *(psp + 4);
-    lr   = *(psp + 5);
-    pc   = *(psp + 6);
-    xpsr = getIpsr();
-    mfault = NVIC_FAULT_STAT_R & 0xFF;       // mem fault  bits [7:0] in FAULTSTAT
-    // offending instruction will be stored inside register NVIC_MM_ADDR_R which can only be accessed in priv
-    address = pc;
-    uint32_t opcode = *((uint32_t*)(address));
-
-    putsUart0("MPU fault in process   "); putsUart0(uitoa(pid));                  putcUart0('\n');
-    putsUart0("PSP:                   "); putsUart0(inttohex((uint32_t)psp));        putcUart0('\n');
-    putsUart0("MSP:                   "); putsUart0(inttohex((uint32_t)msp));        putcUart0('\n');
-    putsUart0("MFault Flags:          "); putsUart0(inttohex(mfault));            putcUart0('\n');
-    putsUart0("Offending Instruction: "); putsUart0(inttohex((uint32_t)opcode));  putcUart0('\n');
-    putsUart0("Address of Instruction:"); putsUart0(inttohex(address));              putcUart0('\n');
-    putsUart0("Stack Dump!!");                                                    putcUart0('\n');
-    putsUart0("xPSR:                  "); putsUart0(inttohex(xpsr));                 putcUart0('\n');
-    putsUart0("PC:                    "); putsUart0(inttohex(pc));                   putcUart0('\n');
-    putsUart0("LR:                    "); putsUart0(inttohex(lr));                   putcUart0('\n');
-    putsUart0("R12:                   "); putsUart0(inttohex(r12));                  putcUart0('\n');
-    putsUart0("R3:                    "); putsUart0(inttohex(r3));                   putcUart0('\n');
-    putsUart0("R2:                    "); putsUart0(inttohex(r2));                   putcUart0('\n');
-    putsUart0("R1:                    "); putsUart0(inttohex(r1));                   putcUart0('\n');
-    putsUart0("R0:                    "); putsUart0(inttohex(r0));                   putcUart0('\n');
-
-    while(1);
+    faultCount(COUNT_HARD);
+    crashReset(CRASH_HARD, excReturn, frame, regs);
 }
 
-void pendsvISR()
+// a growing stack takes a block, otherwise the task is killed and the rest
+// keeps running, faults in the kernel reset
+void mpuFaultHandler(uint32_t *frame, uint32_t *regs, uint32_t excReturn)
 {
-    putsUart0("PendSV in process "); putsUart0(uitoa(pid)); putcUart0('\n');
-    // If the MPU DERR or IERR bits are set, clear them and display the message “called from MPU”
-    if (NVIC_FAULT_STAT_R & (NVIC_FAULT_STAT_DERR | NVIC_FAULT_STAT_IERR))
+    uint32_t entryCycles = DWT_CYCCNT_R;    // recovery latency, see switchTask
+    uint32_t pc = (NVIC_FAULT_STAT_R & NVIC_FAULT_STAT_MSTKE) ? 0 : frame[6];  // no frame if stacking faulted
+
+    if ((excReturn & EXC_RETURN_MODE_M) == EXC_RETURN_THREAD_PSP && growFaultedStack())
+        return;                             // the access runs again on the grown stack
+    faultCount(COUNT_MPU);                  // a kill or a reset, not a growth
+    if ((excReturn & EXC_RETURN_MODE_M) == EXC_RETURN_THREAD_PSP && killFaultedTask(pc, (uint32_t)frame, entryCycles))
     {
-        NVIC_FAULT_STAT_R |= (NVIC_FAULT_STAT_DERR | NVIC_FAULT_STAT_IERR); // clear flags
-        putsUart0("called from MPU");
+        if (pc) crashPrintBacktrace(frame, regs, excReturn);  // the freed stack is untouched until the switch
+        return;
     }
+    crashReset(CRASH_MPU, excReturn, frame, regs);
 }
-
-
-
-
-
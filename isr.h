@@ -27,10 +27,11 @@
 
 char* uitoa(uint32_t num);
 char* inttohex(uint32_t num);
-void busFaultISR();
-void usageFaultISR();
-void hardFaultISR();
-void mpuFaultISR();
-void pendsvISR();
+void putsColumn(const char *str, uint8_t width);
+void putsRight(const char *str, uint8_t width);
+void busFaultHandler(uint32_t *frame, uint32_t *regs, uint32_t excReturn);
+void usageFaultHandler(uint32_t *frame, uint32_t *regs, uint32_t excReturn);
+void hardFaultHandler(uint32_t *frame, uint32_t *regs, uint32_t excReturn);
+void mpuFaultHandler(uint32_t *frame, uint32_t *regs, uint32_t excReturn);
 
 #endif
@@ -0,0 +1,887 @@
+// Kernel Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    80 MHz
+
+// Hardware configuration:
+// SysTick:
+//   1 ms kernel tick
+// Kernel:
+// task table, scheduler and syscall dispatcher. Tasks run unprivileged on
+// stacks taken from the heap; pendsvISR (asm.s) saves and restores them and
+// svcISR hands every syscall() to svcCall below
+//
+// exception priorities: faults 0, UARTs 0, SysTick 5, SVCall 6, PendSV 7
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "tm4c123gh6pm.h"
+#include "asm.h"
+#include "isr.h"
+#include "uart0.h"
+#include "mem.h"
+#include "mpu.h"
+#include "log.h"
+#include "telemetry.h"
+#include "kernel.h"
+#include "syscall.h"
+#include "bench.h"
+#include "crash.h"
+#include "button.h"
+#include "clock.h"
+#include "uart.h"
+#include "timebase.h"
+#include "profile.h"
+#include "trace.h"
+#include "latency.h"
+
+#define FLASH_END         0x00040000
+#define START_STACK_WORDS 32
+#define IDLE_STACK        1024
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+TCB tcb[MAX_TASKS];
+uint8_t taskCurrent = NO_TASK;
+uint32_t pid = 0;                       // running process, 0 until the first task starts
+uint32_t nextPid = 1;
+
+bool preemption = true;
+bool priorityScheduler = true;
+bool priorityInheritance = false;
+bool pendsvTriggered = false;           // trig pendsv, logged by the next switch
+uint8_t faultKilled = NO_TASK;          // slot an MPU fault just killed, until the next switch
+uint32_t faultCycles;                   // CYCCNT when that fault was taken
+
+bool governor = GOVERNOR_BOOT;          // clock profile follows the idle share
+bool clockSwitching = false;            // setClockProfile under way, the governor waits
+uint8_t clockRequest = CLOCK_PROFILES;  // profile the governor asked for, switched by the next PendSV
+uint8_t idlePercent = 0;                // of the last governor window
+uint32_t idleCount = 0;                 // time base counts idle ran this window
+uint32_t idleSince;                     // count when idle was switched in
+uint32_t windowStart;                   // count when the window began
+
+uint64_t startStack[START_STACK_WORDS / 2];  // PSP between startRtos and the first switch
+
+extern uint64_t srdBitmask;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// lowest priority and always ready, so the scheduler never runs out of tasks
+void idle(void)
+{
+    while (true)
+    {
+        sysLogFlush();                  // deferred log records go out while nothing else runs
+        __asm(" WFI");
+        sysYield();
+    }
+}
+
+// gives the slot a fresh pid and stack, the stack is built to look like it was saved by pendsvISR
+static bool launchTask(uint8_t i)
+{
+    uint32_t *sp, *w;
+    uint8_t r;
+
+    tcb[i].pid = nextPid++;
+    tcb[i].srd = 0;
+    tcb[i].stackSize -= tcb[i].stackGrown;     // a grown stack starts small again
+    tcb[i].stackGrown = 0;
+    if (tcb[i].stackLimit)                      // room to grow into below it
+        tcb[i].guard = malloc_heap_top_for(GUARD_SIZE + tcb[i].stackSize, tcb[i].pid, &tcb[i].srd);
+    else
+        tcb[i].guard = malloc_heap_for(GUARD_SIZE + tcb[i].stackSize, tcb[i].pid, &tcb[i].srd);
+    if (!tcb[i].guard)
+    {
+        tcb[i].state = STATE_DEAD;
+        return false;
+    }
+    removeSramAccessWindow(&tcb[i].srd, tcb[i].guard, GUARD_SIZE);
+    tcb[i].stackBase = (uint8_t *)tcb[i].guard + GUARD_SIZE;
+    tcb[i].stackPeak = 0;
+
+    sp = (uint32_t *)((uint32_t)tcb[i].stackBase + tcb[i].stackSize);
+    for (w = tcb[i].stackBase; w < sp; w++)
+        *w = STACK_PAINT;
+    *(--sp) = 0x01000000;                       // xPSR, Thumb bit
+    *(--sp) = (uint32_t)tcb[i].entry & ~1;      // PC
+    *(--sp) = (uint32_t)sysExit;                // LR, a task that returns exits
+    for (r = 0; r < 5; r++)
+        *(--sp) = 0;                            // R12, R3-R0
+    *(--sp) = 0xFFFFFFFD;                       // EXC_RETURN: thread mode, PSP, no FPU frame
+    for (r = 0; r < 8; r++)
+        *(--sp) = 0;                            // R11-R4
+
+    tcb[i].sp = sp;
+    tcb[i].wait = WAIT_NONE;
+    tcb[i].ticks = 0;
+    tcb[i].state = STATE_READY;
+    return true;
+}
+
+// deepest stack use of slot i in bytes. The used part only grows downward, so
+// the scan stops at the first painted over word or at the last known peak
+uint32_t stackPeak(uint8_t i)
+{
+    uint32_t *w = tcb[i].stackBase;
+    uint32_t *top = (uint32_t *)((uint32_t)tcb[i].stackBase + tcb[i].stackSize);
+    uint32_t *end = (uint32_t *)((uint32_t)top - tcb[i].stackPeak);
+
+    while (w < end && *w == STACK_PAINT)
+        w++;
+    if (w < end)
+        tcb[i].stackPeak = (uint32_t)top - (uint32_t)w;
+    return tcb[i].stackPeak;
+}
+
+// the free block below the guard joins the stack: the old guard opens and is
+// painted like the rest, the new one stays shut. srdMask is the task's mask,
+// the caller applies it. False at the limit or with the block below in use
+static bool growTaskStack(TCB *task, uint64_t *srdMask)
+{
+    uint32_t *w;
+
+    if (!task->stackLimit || task->stackSize + GUARD_SIZE > task->stackLimit) return false;
+    if (!grow_heap_down(task->guard, task->pid)) return false;
+
+    addSramAccessWindow(srdMask, task->guard, GUARD_SIZE);
+    for (w = task->guard; w < (uint32_t *)task->stackBase; w++)
+        *w = STACK_PAINT;
+    task->stackBase = task->guard;
+    task->guard = (uint8_t *)task->guard - GUARD_SIZE;
+    task->stackSize += GUARD_SIZE;
+    task->stackGrown += GUARD_SIZE;
+    return true;
+}
+
+#if STACK_CHECK_TICKS
+// one task per call, from systickISR, so a check costs at most one stack scan
+static void stackCheck(void)
+{
+    static uint8_t next = 0;
+    uint32_t before;
+
+    next = (next + 1) % MAX_TASKS;
+    if (tcb[next].state == STATE_INVALID || tcb[next].state == STATE_DEAD) return;
+    before = tcb[next].stackPeak;
+    if (stackPeak(next) * 100 > tcb[next].stackSize * STACK_WARN_PERCENT
+        && before * 100 <= tcb[next].stackSize * STACK_WARN_PERCENT)
+        LOG3(LOG_STACK_HIGH, tcb[next].pid, tcb[next].stackPeak, tcb[next].stackSize);
+}
+#endif
+
+// stack rounded up to whole blocks, heapQuota in blocks on top of the stack
+bool createThread(_fn fn, const char name[], uint8_t priority, uint32_t stackBytes, uint8_t heapQuota)
+{
+    uint8_t i;
+    for (i = 0; i < MAX_TASKS && tcb[i].state != STATE_INVALID; i++);
+    if (i == MAX_TASKS || stackBytes == 0) return false;
+
+    strncpy(tcb[i].name, name, TASK_NAME_SIZE - 1);
+    tcb[i].name[TASK_NAME_SIZE - 1] = '\0';
+    tcb[i].entry = fn;
+    tcb[i].priority = priority;
+    tcb[i].stackSize = (stackBytes + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1);
+    tcb[i].heapQuota = heapQuota;
+    return launchTask(i);
+}
+
+// idle is always slot 0
+void initRtos(void)
+{
+    memset(tcb, 0, sizeof(tcb));
+    taskCurrent = NO_TASK;
+
+    NVIC_SYS_PRI2_R = (NVIC_SYS_PRI2_R & ~NVIC_SYS_PRI2_SVC_M) | (6 << NVIC_SYS_PRI2_SVC_S);
+    NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R & ~(NVIC_SYS_PRI3_TICK_M | NVIC_SYS_PRI3_PENDSV_M))
+                    | (5 << NVIC_SYS_PRI3_TICK_S) | (7 << NVIC_SYS_PRI3_PENDSV_S);
+
+    NVIC_ST_CTRL_R = 0;
+    NVIC_ST_RELOAD_R = systemClockHz / SYSTICK_HZ - 1;
+    NVIC_ST_CURRENT_R = 0;
+
+    createThread(idle, "idle", LOWEST_PRIORITY, IDLE_STACK, 0);
+}
+
+// never returns, the first PendSV drops privilege and starts the highest priority task
+void startRtos(void)
+{
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_INTEN | NVIC_ST_CTRL_ENABLE;
+    setPsp((uint32_t *)&startStack[START_STACK_WORDS / 2]);
+    setAspOn();
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    while (true);
+}
+
+// priority scheduling picks the best ready task, ties (and rr) go round robin from the current one
+static uint8_t nextTask(void)
+{
+    uint8_t start = (taskCurrent == NO_TASK) ? 0 : taskCurrent + 1;
+    uint8_t best = NO_TASK;
+    uint8_t k, i;
+
+    for (k = 0; k < MAX_TASKS; k++)
+    {
+        i = (start + k) % MAX_TASKS;
+        if (tcb[i].state != STATE_READY) continue;
+        if (!priorityScheduler) return i;
+        if (best == NO_TASK || tcb[i].priority < tcb[best].priority) best = i;
+    }
+    return best;
+}
+
+// called by pendsvISR with the sp it saved r4-r11 to, returns the sp to restore from
+uint32_t *switchTask(uint32_t *sp)
+{
+    uint32_t mfault, now;
+
+    if (taskCurrent == NO_TASK)
+        setPrivOff();                   // first switch, thread mode is unprivileged from here on
+    else if (tcb[taskCurrent].state == STATE_RUNNING || tcb[taskCurrent].state == STATE_BLOCKED
+          || tcb[taskCurrent].state == STATE_READY)   // woken by an interrupt before this PendSV ran
+    {
+        tcb[taskCurrent].sp = sp;
+        tcb[taskCurrent].srd = srdBitmask;
+        // a growing stack takes its next block here, before the task reaches the guard
+        if ((uint32_t)sp < (uint32_t)tcb[taskCurrent].stackBase + STACK_GROW_MARGIN
+            && growTaskStack(&tcb[taskCurrent], &tcb[taskCurrent].srd))
+            LOG3(LOG_STACK_GROW, pid, tcb[taskCurrent].stackSize, (uint32_t)sp);
+        if (tcb[taskCurrent].state == STATE_RUNNING)
+            tcb[taskCurrent].state = STATE_READY;
+    }
+
+    // If the MPU DERR or IERR bits are set, clear them and log “called from MPU”
+    mfault = NVIC_FAULT_STAT_R & (NVIC_FAULT_STAT_DERR | NVIC_FAULT_STAT_IERR);
+    if (mfault)
+    {
+        NVIC_FAULT_STAT_R = mfault;     // clear flags (write 1 to clear)
+        faultCount(COUNT_PENDSV);       // only the PendSVs an MPU fault handed over, not every switch
+        LOG2(LOG_PENDSV_MPU, pid, mfault);
+    }
+    else if (pendsvTriggered)
+        LOG1(LOG_PENDSV, pid);
+    pendsvTriggered = false;
+
+    // the governor's switch, unless the console woke up since it asked
+    if (clockRequest < CLOCK_PROFILES)
+    {
+        if (governor && uartsIdle())
+            setClockProfile(clockRequest);
+        clockRequest = CLOCK_PROFILES;
+    }
+
+    // the old stack was only given up once pendsvISR stopped writing to it
+    if (faultKilled != NO_TASK && tcb[faultKilled].respawn)
+        launchTask(faultKilled);
+
+    // idle time for the governor, from the time base: CYCCNT stops in WFI
+    now = (uint32_t)timeCount();
+    if (taskCurrent == 0)
+        idleCount += now - idleSince;
+    taskCurrent = nextTask();
+    if (taskCurrent == 0)
+        idleSince = now;
+    tcb[taskCurrent].state = STATE_RUNNING;
+    pid = tcb[taskCurrent].pid;
+    TRACE_POINT(TRACE_SWITCH, pid);
+    srdBitmask = tcb[taskCurrent].srd;
+    applySramAccessMask(srdBitmask);
+
+    if (faultKilled != NO_TASK)
+    {
+        uint32_t cycles = DWT_CYCCNT_R - faultCycles;
+        LOG2(LOG_FAULT_RECOVERED, pid, cycles);
+        putsUart0("process "); putsUart0(uitoa(pid)); putsUart0(" running ");
+        putsUart0(uitoa(cycles)); putsUart0(" cycles after the fault\n");
+        faultKilled = NO_TASK;
+    }
+    return tcb[taskCurrent].sp;
+}
+
+// closes an idle window: fastest profile at once when idle falls below
+// GOVERNOR_UP_IDLE, one profile slower when it stays above GOVERNOR_DOWN_IDLE.
+// A switch waits for a window with the UARTs idle both ways, so no byte is
+// re-timed mid-character, and only asks for it: the PLL relock runs in the
+// next PendSV, below every interrupt, not in the tick
+static void governorWindow(void)
+{
+    uint32_t now = (uint32_t)timeCount();
+    uint32_t window = now - windowStart;
+    uint8_t profile = clockProfile;
+
+    if (taskCurrent == 0)               // this tick woke idle from WFI
+    {
+        idleCount += now - idleSince;
+        idleSince = now;
+    }
+    idlePercent = window ? (uint64_t)idleCount * 100 / window : 0;
+    idleCount = 0;
+    windowStart = now;
+
+    if (!governor || clockSwitching || clockProfile >= CLOCK_PROFILES || !uartsIdle()) return;
+    if (idlePercent < GOVERNOR_UP_IDLE)
+        profile = CLOCK_PROFILES - 1;
+    else if (idlePercent > GOVERNOR_DOWN_IDLE && profile > 0)
+        profile--;
+    if (profile != clockProfile)
+    {
+        clockRequest = profile;
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    }
+}
+
+// wakes sleepers and console readers, time slices when preemption is on
+void systickISR(void)
+{
+    uint8_t i;
+    static uint32_t governorTicks = 0;
+#if STACK_CHECK_TICKS
+    static uint32_t stackTicks = 0;
+#endif
+
+    TRACE_POINT(TRACE_ISR_ENTER, 15);   // SysTick exception
+#if STACK_CHECK_TICKS
+    if (++stackTicks == STACK_CHECK_TICKS)
+    {
+        stackTicks = 0;
+        stackCheck();
+    }
+#endif
+    if (++governorTicks == GOVERNOR_TICKS)
+    {
+        governorTicks = 0;
+        governorWindow();
+    }
+    for (i = 0; i < MAX_TASKS; i++)
+    {
+        if (tcb[i].state != STATE_BLOCKED) continue;
+        if ((tcb[i].wait == WAIT_SLEEP && --tcb[i].ticks == 0)
+         || (tcb[i].wait == WAIT_CONSOLE && kbhitUart0()))
+        {
+            tcb[i].wait = WAIT_NONE;
+            tcb[i].state = STATE_READY;
+            TRACE_POINT(TRACE_WAKE, tcb[i].pid);
+        }
+    }
+    if (preemption)
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    TRACE_POINT(TRACE_ISR_EXIT, 15);
+}
+
+// an interrupt's own wake up, the first task blocked on reason is made ready
+// and PendSV runs it without waiting for the tick. False when none waits
+bool wakeWaiting(WAIT_REASON reason)
+{
+    uint8_t i;
+    for (i = 0; i < MAX_TASKS; i++)
+    {
+        if (tcb[i].state != STATE_BLOCKED || tcb[i].wait != reason) continue;
+        tcb[i].wait = WAIT_NONE;
+        tcb[i].state = STATE_READY;
+        TRACE_POINT(TRACE_WAKE, tcb[i].pid);
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+        return true;
+    }
+    return false;
+}
+
+static void blockCurrent(WAIT_REASON reason, uint32_t ticks)
+{
+    tcb[taskCurrent].ticks = ticks;
+    tcb[taskCurrent].wait = reason;
+    tcb[taskCurrent].state = STATE_BLOCKED;
+    TRACE_POINT(TRACE_BLOCK, reason);
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+}
+
+static uint8_t findTask(uint32_t pidK)
+{
+    uint8_t i;
+    for (i = 0; i < MAX_TASKS; i++)
+        if (tcb[i].pid == pidK && tcb[i].state != STATE_INVALID && tcb[i].state != STATE_DEAD)
+            return i;
+    return NO_TASK;
+}
+
+static uint8_t findTaskName(const char *name)
+{
+    uint8_t i;
+    for (i = 0; i < MAX_TASKS; i++)
+        if (tcb[i].state != STATE_INVALID && strcmp(tcb[i].name, name) == 0)
+            return i;
+    return NO_TASK;
+}
+
+// strings handed to the kernel must be in flash or in blocks the caller owns,
+// every byte up to the terminator: each block the string reaches is checked
+// before the kernel reads from it
+static bool userReadable(uint32_t address)
+{
+    uint32_t checked = 0;               // end of the flash or block checked last
+
+    if (address == 0) return false;
+    while (true)
+    {
+        if (address >= checked)
+        {
+            if (address < FLASH_END)
+                checked = FLASH_END;
+            else if (address >= HEAP_START && address < HEAP_END)
+            {
+                BLOCK *block = &blockArray[(address - HEAP_START) / BLOCK_SIZE];
+                if (!block->alloc || block->owner != pid) return false;
+                checked = address - (address - HEAP_START) % BLOCK_SIZE + BLOCK_SIZE;
+            }
+            else
+                return false;
+        }
+        if (*(const char *)address == '\0') return true;
+        address++;
+    }
+}
+
+// guard and stack blocks of a task
+static int stackBlocks(uint8_t i)
+{
+    return (GUARD_SIZE + tcb[i].stackSize) / BLOCK_SIZE;
+}
+
+// the stack does not count against the heap quota
+static bool withinQuota(uint32_t bytes)
+{
+    int blocks = (bytes + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int heapBlocks = heapBlocksOwned(pid) - stackBlocks(taskCurrent);
+    return heapBlocks + blocks <= tcb[taskCurrent].heapQuota;
+}
+
+void ps(void)
+{
+    static const char *stateName[] = {"invalid", "running", "ready", "blocked", "dead"};
+    uint8_t i;
+
+    putsUart0("PID   NAME        STATE    PRIO  STACK  PEAK   HEAP\n");
+    for (i = 0; i < MAX_TASKS; i++)
+    {
+        if (tcb[i].state == STATE_INVALID) continue;
+        putsColumn(uitoa(tcb[i].pid), 6);
+        putsColumn(tcb[i].name, 12);
+        putsColumn(stateName[tcb[i].state], 9);
+        putsColumn(uitoa(tcb[i].priority), 6);
+        putsColumn(uitoa(tcb[i].stackSize), 7);
+        if (tcb[i].state != STATE_DEAD)
+        {
+            putsColumn(uitoa(stackPeak(i)), 7);
+            putsUart0(uitoa(heapBlocksOwned(tcb[i].pid) - stackBlocks(i)));
+            putcUart0('/');
+            putsUart0(uitoa(tcb[i].heapQuota));
+        }
+        putcUart0('\n');
+    }
+}
+
+void ipcs(void)
+{
+    putsUart0("no semaphores or mutexes");
+}
+
+// frees the stack and heap of the process, idle can't be killed
+bool kill(uint32_t pidK)
+{
+    uint8_t i = findTask(pidK);
+    if (i == NO_TASK || i == 0) return false;
+
+    free_heap_owner(pidK, (i == taskCurrent) ? &srdBitmask : &tcb[i].srd);
+    tcb[i].state = STATE_DEAD;
+    tcb[i].wait = WAIT_NONE;
+    if (i == taskCurrent)
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    return true;
+}
+
+bool pkill(const char *processName)
+{
+    uint8_t i = findTaskName(processName);
+    return i != NO_TASK && kill(tcb[i].pid);
+}
+
+void pi(bool on)
+{
+    priorityInheritance = on;
+}
+
+void preempt(bool on)
+{
+    preemption = on;
+}
+
+void sched(bool prioOn)  // true = priority scheduling, false = round robin scheduling
+{
+    priorityScheduler = prioOn;
+}
+
+uint32_t pidof(const char *name)
+{
+    uint8_t i = findTaskName(name);
+    if (i == NO_TASK || tcb[i].state == STATE_DEAD) return 0;
+    return tcb[i].pid;
+}
+
+// restarts a killed task with a new pid
+bool run(const char *name)
+{
+    uint8_t i = findTaskName(name);
+    if (i == NO_TASK || tcb[i].state != STATE_DEAD) return false;
+    return launchTask(i);
+}
+
+// the task is launched again (new pid, fresh stack) whenever an MPU fault kills it
+bool respawn(const char *name)
+{
+    uint8_t i = findTaskName(name);
+    if (i == NO_TASK) return false;
+    tcb[i].respawn = true;
+    return true;
+}
+
+// opt in to a stack that grows a block at a time, up to limitBytes. A task
+// that has not run yet moves to the top of the heap now, any other one at
+// its next launch
+bool growStack(const char *name, uint32_t limitBytes)
+{
+    uint8_t i = findTaskName(name);
+    if (i == NO_TASK) return false;
+    tcb[i].stackLimit = limitBytes;
+    if (taskCurrent == NO_TASK && tcb[i].state == STATE_READY)
+    {
+        free_heap_owner(tcb[i].pid, &tcb[i].srd);
+        return launchTask(i);
+    }
+    return true;
+}
+
+// mpuFaultHandler, before killFaultedTask: a growing task's data access into
+// its guard that switchTask did not see coming. True when the stack took the
+// next block and the access can be retried. A push into the guard also
+// faults the exception stacking (MSTKERR): that frame sits in the guard,
+// there is nothing to return to, it stays an overflow
+bool growFaultedStack(void)
+{
+    uint32_t status = NVIC_FAULT_STAT_R;
+    uint32_t mmfar = NVIC_MM_ADDR_R;
+    TCB *task;
+
+    if (taskCurrent == NO_TASK || taskCurrent == 0) return false;
+    task = &tcb[taskCurrent];
+    if (status & NVIC_FAULT_STAT_MSTKE) return false;
+    if ((status & (NVIC_FAULT_STAT_MMARV | NVIC_FAULT_STAT_DERR)) != (NVIC_FAULT_STAT_MMARV | NVIC_FAULT_STAT_DERR))
+        return false;
+    if (mmfar < (uint32_t)task->guard || mmfar >= (uint32_t)task->stackBase) return false;
+    if (!growTaskStack(task, &srdBitmask)) return false;
+    applySramAccessMask(srdBitmask);
+
+    NVIC_FAULT_STAT_R = NVIC_FAULT_STAT_MMARV | NVIC_FAULT_STAT_DERR;   // write 1 to clear
+    LOG3(LOG_STACK_GROW, pid, task->stackSize, mmfar);
+    return true;
+}
+
+// mpuFaultHandler, the running task broke the MPU rules from thread mode.
+// Only that task dies, the pended switch runs the next one. False when no
+// task is to blame (before startRtos or idle itself), the caller resets then
+bool killFaultedTask(uint32_t pc, uint32_t sp, uint32_t entryCycles)
+{
+    uint32_t mmfar = NVIC_MM_ADDR_R;
+    uint32_t stackBase;
+    bool overflow;
+
+    if (taskCurrent == NO_TASK || taskCurrent == 0) return false;
+
+    // sp below the stack (stacking hit the guard) or an access into the guard
+    stackBase = (uint32_t)tcb[taskCurrent].stackBase;
+    overflow = sp < stackBase || ((NVIC_FAULT_STAT_R & NVIC_FAULT_STAT_MMARV)
+                                  && mmfar >= (uint32_t)tcb[taskCurrent].guard && mmfar < stackBase);
+    if (overflow)
+    {
+        LOG3(LOG_STACK_OVERFLOW, pid, pc, sp);
+        putsUart0("Stack overflow in process ");
+    }
+    else
+    {
+        LOG3(LOG_MPU_KILL, pid, pc, mmfar);
+        putsUart0("MPU fault in process ");
+    }
+    putsUart0(uitoa(pid));
+    putsUart0(" at pc "); putsUart0(inttohex(pc)); putsUart0(", killed\n");
+
+    // MMFSR stays set, switchTask clears DERR/IERR and logs "called from MPU"
+    NVIC_SYS_HND_CTRL_R &= ~NVIC_SYS_HND_CTRL_MEMP;
+    faultKilled = taskCurrent;
+    faultCycles = entryCycles;
+    return kill(pid);
+}
+
+// every open UART, the SysTick reload, the profiler and the latency timer after a clock
+// change (the button debounce and the time base follow systemClockHz themselves)
+static void retimeClock(uint32_t oldHz)
+{
+    TRACE_POINT(TRACE_CLOCK, (oldHz / 1000000) << 8 | systemClockHz / 1000000);
+    setUartsClock(systemClockHz);
+    NVIC_ST_RELOAD_R = systemClockHz / SYSTICK_HZ - 1;
+    NVIC_ST_CURRENT_R = 0;
+    profileRetime();
+    latencyRetime();
+}
+
+// switches the core clock and re-times what divides it. Bytes still queued go
+// out at the old rate first. Between two PLL profiles the core drops to the
+// crystal and is re-timed for 16 MHz before the PLL relocks. setSystemClock
+// keeps the divider out until the lock, so the core really runs at 16 MHz
+// meanwhile and only the instant of each switch is off. False
+// when the profile could not be reached, systemClockHz is still right then
+bool setClockProfile(uint8_t profile)
+{
+    bool ok = true;
+    uint32_t hz;
+
+    if (profile >= CLOCK_PROFILES) return false;
+    if (profile == clockProfile) return true;
+
+    clockSwitching = true;
+    flushUarts();
+    if (clockProfile != CLOCK_16MHZ && clockProfile < CLOCK_PROFILES)
+    {
+        hz = systemClockHz;
+        setSystemClock(CLOCK_16MHZ);
+        retimeClock(hz);
+    }
+    if (profile != clockProfile)
+    {
+        hz = systemClockHz;
+        ok = setSystemClock((CLOCK_PROFILE)profile);
+        retimeClock(hz);
+    }
+    clockSwitching = false;
+    LOG2(LOG_CLOCK, systemClockHz, ok);
+    return ok;
+}
+
+void reboot(void)
+{
+    faultSeal();                        // fault counters carry over
+    NVIC_APINT_R = NVIC_APINT_VECTKEY | NVIC_APINT_SYSRESETREQ;
+    while (true);
+}
+
+// privileged half of the trig command
+static void trigSetup(TRIG_SETUP setup)
+{
+    switch (setup)
+    {
+    case TRIG_HARD:
+        NVIC_SYS_HND_CTRL_R &= ~NVIC_SYS_HND_CTRL_USAGE;    // disable usage fault handler
+        // fall through
+    case TRIG_USAGE:
+        NVIC_CFG_CTRL_R |= NVIC_CFG_CTRL_DIV0;              // trap divide by 0
+        break;
+    case TRIG_PENDSV:
+        pendsvTriggered = true;
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+        break;
+    }
+}
+
+// frame[0] = SVC number in, result out, frame[1-3] = arguments
+void svcCall(uint32_t *frame)
+{
+    uint32_t a = frame[1];
+    uint32_t result = 0;
+    uint32_t primask;
+    uint8_t event;
+
+    TRACE_POINT(TRACE_SVC_ENTER, frame[0]);
+    switch (frame[0])
+    {
+    case SVC_YIELD:
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+        break;
+    case SVC_SLEEP:
+        if (a) blockCurrent(WAIT_SLEEP, a);
+        break;
+    case SVC_EXIT:
+        kill(pid);
+        break;
+    case SVC_PUTC:
+        putcUart0(a);
+        break;
+    case SVC_PUTS:
+        if (userReadable(a)) putsUart0((char*)a);
+        break;
+    case SVC_GETC:
+        if (kbhitUart0())
+            result = getcUart0();
+        else
+        {
+            blockCurrent(WAIT_CONSOLE, 0);
+            result = (uint32_t)-1;
+        }
+        break;
+    case SVC_CLOCK:
+        if (a != CLOCK_PROFILES)
+        {
+            governor = false;           // a fixed profile stays
+            setClockProfile(a);
+        }
+        result = systemClockHz;
+        break;
+    case SVC_PROFILE:
+        if (a == 0)
+            profileStop();
+        else if (a != PROFILE_STATUS && !profileStart(a))
+        {
+            putsUart0("profile: no heap for the histogram");
+            break;
+        }
+        profilePrint();
+        break;
+    case SVC_TRACE:
+        if (a == 0)
+            traceStop();
+        else if (a == 1 && !traceStart())
+        {
+            putsUart0("trace: no heap for the ring");
+            break;
+        }
+        tracePrint();
+        break;
+    case SVC_LATENCY:
+        if (a == 0)
+            latencyStop();
+        else if (a != LATENCY_QUERY && a != LATENCY_REPORT && !latencyStart(a))
+        {
+            putsUart0("latency: no heap for the samples");
+            break;
+        }
+        if (a == LATENCY_REPORT)
+            latencyPrint();
+        result = latencyLeft();
+        break;
+    case SVC_LATENCY_WAIT:
+        latencyRecordWake(a);
+        blockCurrent(WAIT_LATENCY, 0);
+        break;
+    case SVC_LOAD_WAIT:
+        if (!latencyLeft())
+            blockCurrent(WAIT_LOAD, 0);
+        break;
+    case SVC_GOVERNOR:
+        if (a <= 1)
+            governor = a;
+        result = (governor << 8) | idlePercent;
+        break;
+    case SVC_BUTTON:
+        primask = _disable_interrupts();    // timer1AIsr must not queue between the check and the block
+        if (!getButtonEvent(&event))
+        {
+            blockCurrent(WAIT_BUTTON, 0);
+            result = (uint32_t)-1;
+        }
+        else
+            result = event;
+        _restore_interrupts(primask);
+        break;
+    case SVC_MALLOC:
+        if (withinQuota(a))
+            result = (uint32_t)malloc_heap(a);
+        else
+            LOG2(LOG_MALLOC_FAIL, pid, a);
+        break;
+    case SVC_FREE:
+        if (a < (uint32_t)tcb[taskCurrent].guard    // the guard and stack are one allocation
+            || a >= (uint32_t)tcb[taskCurrent].stackBase + tcb[taskCurrent].stackSize)
+            free_heap((void*)a);
+        break;
+    case SVC_DUMP_HEAP:
+        dumpHeap();
+        break;
+    case SVC_PS:
+        ps();
+        break;
+    case SVC_IPCS:
+        ipcs();
+        break;
+    case SVC_KILL:
+        result = kill(a);
+        break;
+    case SVC_PKILL:
+        result = userReadable(a) && pkill((char*)a);
+        break;
+    case SVC_PIDOF:
+        if (userReadable(a)) result = pidof((char*)a);
+        break;
+    case SVC_RUN:
+        result = userReadable(a) && run((char*)a);
+        break;
+    case SVC_PI:
+        pi(a);
+        break;
+    case SVC_PREEMPT:
+        preempt(a);
+        break;
+    case SVC_SCHED:
+        sched(a);
+        break;
+    case SVC_REBOOT:
+        reboot();
+        break;
+    case SVC_MPU_REGION:
+        if (a < 8)
+        {
+            NVIC_MPU_NUMBER_R = a;
+            result = NVIC_MPU_ATTR_R;
+        }
+        break;
+    case SVC_TLM:
+        if      (a == TLM_HEAP)  tlmSendHeap();
+        else if (a == TLM_MPU)   tlmSendMpu();
+        else if (a == TLM_TASKS) tlmSendTasks();
+        else if (a == TLM_FAULTS) tlmSendFaults();
+        else if (a == TLM_PROFILE) tlmSendProfile();
+        else if (a == TLM_TRACE) tlmSendTrace();
+        break;
+    case SVC_TLM_UART:
+        tlmUseUart(a, TLM_FAST_BAUD, systemClockHz);
+        break;
+    case SVC_TRIG:
+        trigSetup((TRIG_SETUP)a);
+        break;
+    case SVC_LOG_FLUSH:
+        if (logPending()) logFlush();
+        break;
+    case SVC_BENCH:
+        bench();
+        break;
+    case SVC_CRASH:
+        crashPrint();
+        break;
+    case SVC_FAULTS:
+        faultPrint();
+        break;
+    }
+    TRACE_POINT(TRACE_SVC_EXIT, frame[0]);
+    frame[0] = result;
+}
@@ -0,0 +1,152 @@
+// Kernel Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    80 MHz
+
+// Hardware configuration:
+// SysTick:
+//   1 ms kernel tick (sleep timeouts, console wakeups, preemption)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef KERNEL_H_
+#define KERNEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               TASK STACK AT CREATION (grows down, sp points at r4)
+ * ==========================================================================
+ *  top   xPSR (Thumb)  PC (entry)  LR (sysExit)  R12  R3  R2  R1  R0     <- hardware frame
+ *        EXC_RETURN (thread, PSP, no FPU)  R11 ... R4                    <- pendsvISR
+ *
+ *  every task runs unprivileged on its own heap blocks, the kernel is only
+ *  reached through syscall() (syscall.h)
+ *
+ *  one more block below the stack is the guard: the task owns it, so no
+ *  malloc hands it out, but its SRD bit is never set, so the first push
+ *  past the stack is an MPU fault blamed on the right task
+ *
+ *  stackBase + stackSize   top of stack
+ *  stackBase               lowest stack word
+ *  guard                   GUARD_SIZE bytes, no access for the task
+ *
+ *  the stack is painted with STACK_PAINT at launch. stackPeak scans up from
+ *  stackBase to the first word that changed, the bytes above it are the
+ *  deepest the task has gone so far (ps, tlm tasks)
+ *
+ *  a task given a stackLimit (growStack) starts small at the top of the
+ *  heap. When a switch saves its sp within STACK_GROW_MARGIN of stackBase,
+ *  the free block below the guard is taken, the guard moves down and the old
+ *  guard joins the stack. A data access into the guard between two switches
+ *  does the same from the MPU fault handler and is tried again. No free
+ *  block below, the limit reached or a push into the guard (the exception
+ *  frame goes there too, MSTKERR) is an overflow
+ */
+
+#define MAX_TASKS       8
+#define TASK_NAME_SIZE  12
+#define NO_TASK         0xFF
+#define LOWEST_PRIORITY 15
+#define GUARD_SIZE      1024        // one heap block
+#define STACK_PAINT     0xC5C5C5C5
+#define STACK_GROW_MARGIN 256       // more than a task frame plus an FPU exception frame
+#define STACK_CHECK_TICKS 0         // 0 off, else one task's stack is scanned every N ticks
+#define STACK_WARN_PERCENT 75       // the periodic check logs a task going past this
+
+#define SYSTICK_HZ      1000
+#define CONSOLE_BAUD    115200
+#define BOOT_CLOCK      CLOCK_80MHZ // clock.h, systemClockHz holds the clock in use
+#define GOVERNOR_BOOT   true        // the clock profile follows the idle share from boot on
+#define GOVERNOR_TICKS  100         // window the idle share is measured over
+#define GOVERNOR_UP_IDLE   20       // idle % below this: straight to the fastest profile
+#define GOVERNOR_DOWN_IDLE 60       // idle % above this: one profile slower
+
+// values match the TLM_TASKS record
+typedef enum _TASK_STATE
+{
+    STATE_INVALID = 0,      // free slot
+    STATE_RUNNING = 1,
+    STATE_READY   = 2,
+    STATE_BLOCKED = 3,
+    STATE_DEAD    = 4       // killed, entry kept so run NAME can restart it
+} TASK_STATE;
+
+typedef enum _WAIT_REASON
+{
+    WAIT_NONE,
+    WAIT_SLEEP,             // ticks left in TCB.ticks
+    WAIT_CONSOLE,           // woken by the tick once UART0 has a character
+    WAIT_BUTTON,            // woken by the debounce interrupt as it queues an event (button.c)
+    WAIT_LATENCY,           // woken by the latency timer interrupt itself (latency.h)
+    WAIT_LOAD               // woken by latencyStart as a run begins
+} WAIT_REASON;
+
+typedef void (*_fn)(void);
+
+typedef struct _TCB
+{
+    TASK_STATE state;
+    WAIT_REASON wait;
+    uint32_t pid;
+    char name[TASK_NAME_SIZE];
+    _fn entry;
+    void *sp;               // saved PSP while not running
+    void *stackBase;        // lowest address of the stack blocks
+    void *guard;            // guard block right below stackBase, also the allocation
+    uint32_t stackSize;
+    uint32_t stackPeak;     // deepest use seen in bytes, see stackPeak()
+    uint32_t stackLimit;    // stack grows on demand up to this, 0 fixed size
+    uint32_t stackGrown;    // bytes added since launch, given back on relaunch
+    uint64_t srd;           // SRD bits of every block the task owns
+    uint8_t priority;       // 0 highest
+    uint8_t heapQuota;      // heap blocks allowed on top of the stack
+    uint32_t ticks;
+    bool respawn;           // launched again when an MPU fault kills it
+} TCB;
+
+extern TCB tcb[MAX_TASKS];
+extern uint8_t taskCurrent;
+extern uint32_t pid;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initRtos(void);
+bool createThread(_fn fn, const char name[], uint8_t priority, uint32_t stackBytes, uint8_t heapQuota);
+void startRtos(void);
+
+void ps(void);
+void ipcs(void);
+bool kill(uint32_t pidK);
+bool pkill(const char *processName);
+void pi(bool on);
+void preempt(bool on);
+void sched(bool prioOn);
+uint32_t pidof(const char *name);
+bool run(const char *name);
+bool respawn(const char *name);
+bool growStack(const char *name, uint32_t limitBytes);
+bool growFaultedStack(void);
+bool setClockProfile(uint8_t profile);
+bool wakeWaiting(WAIT_REASON reason);
+bool killFaultedTask(uint32_t pc, uint32_t sp, uint32_t entryCycles);
+uint32_t stackPeak(uint8_t i);
+void reboot(void);
+
+uint32_t *switchTask(uint32_t *sp);
+void svcCall(uint32_t *frame);
+void systickISR(void);
+
+#endif
@@ -0,0 +1,309 @@
+// Interrupt Latency Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Latency Timer:
+//   Timer 3A periodic every LATENCY_PERIOD_US at the core clock. QEMU has no
+//   Timer 3, timer 1 of the CMSDK dual timer counts down in its place. Both
+//   are peripherals, so the unprivileged latency task reads them directly
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "tm4c123gh6pm.h"
+#include "isr.h"
+#include "uart0.h"
+#include "mem.h"
+#include "clock.h"
+#include "kernel.h"
+#include "trace.h"
+#include "latency.h"
+
+#ifndef QEMU_MPS2
+#define IRQ_LATENCY         (INT_TIMER3A - 16)
+#else
+#define DUALTIMER1_LOAD_R       (*((volatile uint32_t *)0x40002000))
+#define DUALTIMER1_VALUE_R      (*((volatile uint32_t *)0x40002004))
+#define DUALTIMER1_CTRL_R       (*((volatile uint32_t *)0x40002008))
+#define DUALTIMER1_INTCLR_R     (*((volatile uint32_t *)0x4000200C))
+#define DUALTIMER_CTRL_32BIT    0x00000002
+#define DUALTIMER_CTRL_INTEN    0x00000020
+#define DUALTIMER_CTRL_PERIODIC 0x00000040
+#define DUALTIMER_CTRL_ENABLE   0x00000080
+#define IRQ_LATENCY         10
+#endif
+
+#define LATENCY_BAR         32          // widest histogram bar
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+uint16_t *latencyIsr = NULL;
+uint16_t *latencyWake = NULL;
+uint32_t latencyTarget = 0;
+uint32_t latencyIsrCount = 0;
+uint32_t latencyWakeCount = 0;
+uint32_t latencyMissed = 0;
+uint32_t latencyOverruns = 0;
+
+static bool latencyRunning = false;
+static bool latencySorted = false;
+static uint32_t latencySeq = 0;         // timeouts this run
+static uint32_t latencyWokenSeq = 0;    // timeout the task was woken for, 0 none
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void latencyTimerLoad(void)
+{
+#ifndef QEMU_MPS2
+    TIMER3_TAILR_R = systemClockHz / 1000000 * LATENCY_PERIOD_US - 1;
+#else
+    DUALTIMER1_LOAD_R = systemClockHz / 1000000 * LATENCY_PERIOD_US - 1;
+#endif
+}
+
+static void latencyTimerStop(void)
+{
+#ifndef QEMU_MPS2
+    TIMER3_CTL_R &= ~TIMER_CTL_TAEN;
+#else
+    DUALTIMER1_CTRL_R = 0;
+#endif
+    latencyRunning = false;
+}
+
+static uint16_t saturate(uint32_t cycles)
+{
+    return cycles > 0xFFFF ? 0xFFFF : cycles;
+}
+
+// a new run of samples (clamped to 1..LATENCY_SAMPLES) of each kind.
+// False when the heap has no room for them
+bool latencyStart(uint32_t samples)
+{
+    uint64_t srd = 0;
+
+    if (latencyIsr == NULL)
+        latencyIsr = malloc_heap_for(2 * LATENCY_SAMPLES * sizeof(uint16_t), 0, &srd);
+    if (latencyIsr == NULL) return false;
+    latencyWake = latencyIsr + LATENCY_SAMPLES;
+
+    latencyTimerStop();
+    latencyTarget = samples == 0 ? 1 : samples > LATENCY_SAMPLES ? LATENCY_SAMPLES : samples;
+    latencyIsrCount = latencyWakeCount = 0;
+    latencyMissed = latencyOverruns = 0;
+    latencySeq = latencyWokenSeq = 0;
+    latencySorted = false;
+    latencyRunning = true;
+
+#ifndef QEMU_MPS2
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R3;
+    _delay_cycles(3);
+    TIMER3_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER3_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    latencyTimerLoad();
+    TIMER3_IMR_R = TIMER_IMR_TATOIM;
+    TIMER3_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER3_CTL_R |= TIMER_CTL_TAEN;
+#else
+    latencyTimerLoad();
+    DUALTIMER1_INTCLR_R = 1;
+    DUALTIMER1_CTRL_R = DUALTIMER_CTRL_ENABLE | DUALTIMER_CTRL_PERIODIC | DUALTIMER_CTRL_INTEN | DUALTIMER_CTRL_32BIT;
+#endif
+    (&NVIC_EN0_R)[IRQ_LATENCY >> 5] = 1 << (IRQ_LATENCY & 31);
+    wakeWaiting(WAIT_LOAD);             // the load starts with the sampling
+    return true;
+}
+
+// the samples taken so far stay for the report
+void latencyStop(void)
+{
+    latencyTimerStop();
+}
+
+// the system clock changed (kernel.c retimeClock), samples across it mix both rates
+void latencyRetime(void)
+{
+    if (latencyRunning)
+        latencyTimerLoad();
+}
+
+// wake samples still to take, 0 when no run is going
+uint32_t latencyLeft(void)
+{
+    return latencyRunning ? latencyTarget - latencyWakeCount : 0;
+}
+
+// cycles since the timer last timed out, callable unprivileged
+uint32_t latencySince(void)
+{
+#ifndef QEMU_MPS2
+    return TIMER3_TAILR_R - TIMER3_TAV_R;
+#else
+    return DUALTIMER1_LOAD_R - DUALTIMER1_VALUE_R;
+#endif
+}
+
+// what the latency task measured after its last wake, from SVC_LATENCY_WAIT.
+// Nothing counts unless this run's timer woke it
+void latencyRecordWake(uint32_t cycles)
+{
+    if (latencyWokenSeq == 0 || cycles == LATENCY_NONE || !latencyRunning)
+    {
+        latencyWokenSeq = 0;
+        return;
+    }
+    if (latencyWokenSeq != latencySeq)
+    {
+        cycles = 0xFFFF;                // timed out again before the task got to it
+        latencyOverruns++;
+    }
+    latencyWokenSeq = 0;
+    latencyWake[latencyWakeCount++] = saturate(cycles);
+    if (latencyWakeCount == latencyTarget)
+        latencyTimerStop();
+}
+
+void timer3AIsr(void)
+{
+    uint32_t cycles = latencySince();
+
+    TRACE_POINT(TRACE_ISR_ENTER, IRQ_LATENCY + 16);
+#ifndef QEMU_MPS2
+    TIMER3_ICR_R = TIMER_ICR_TATOCINT;
+#else
+    DUALTIMER1_INTCLR_R = 1;
+#endif
+    if (latencyIsrCount < latencyTarget)
+        latencyIsr[latencyIsrCount++] = saturate(cycles);
+    latencySeq++;
+    if (wakeWaiting(WAIT_LATENCY))
+        latencyWokenSeq = latencySeq;
+    else
+        latencyMissed++;
+    TRACE_POINT(TRACE_ISR_EXIT, IRQ_LATENCY + 16);
+}
+
+static void sortSamples(uint16_t *s, uint32_t n)
+{
+    uint32_t i, j;
+    uint16_t v;
+
+    for (i = 1; i < n; i++)
+    {
+        v = s[i];
+        for (j = i; j > 0 && s[j - 1] > v; j--)
+            s[j] = s[j - 1];
+        s[j] = v;
+    }
+}
+
+// percentiles of sorted samples, then a histogram with power of 2 bins,
+// every line starts with its newline
+static void printSamples(const char *name, const uint16_t *s, uint32_t n)
+{
+    static const uint8_t percent[] = {50, 90, 99};
+    static const char *percentName[] = {"  p50 ", "  p90 ", "  p99 "};
+    uint32_t bins[LATENCY_BINS];
+    uint32_t i, most = 0, mhz = systemClockHz / 1000000;
+    uint8_t bin, first = LATENCY_BINS, last = 0;
+
+    putcUart0('\n');
+    putsUart0((char*)name);
+    if (n == 0)
+    {
+        putsUart0(" none");
+        return;
+    }
+    putsUart0(" cycles  min ");
+    putsUart0(uitoa(s[0]));
+    for (i = 0; i < sizeof(percent); i++)
+    {
+        putsUart0((char*)percentName[i]);
+        putsUart0(uitoa(s[(n - 1) * percent[i] / 100]));
+    }
+    putsUart0("  max ");
+    putsUart0(uitoa(s[n - 1]));
+    putsUart0(" = ");
+    putsUart0(uitoa(s[n - 1] * 1000 / mhz));
+    putsUart0(" ns, jitter ");
+    putsUart0(uitoa(s[n - 1] - s[0]));
+
+    memset(bins, 0, sizeof(bins));
+    for (i = 0; i < n; i++)
+    {
+        for (bin = 0; (s[i] >> bin) != 0; bin++);
+        bins[bin]++;
+    }
+    for (bin = 0; bin < LATENCY_BINS; bin++)
+    {
+        if (!bins[bin]) continue;
+        if (bin < first) first = bin;
+        last = bin;
+        if (bins[bin] > most) most = bins[bin];
+    }
+    for (bin = first; bin <= last; bin++)
+    {
+        putcUart0('\n');
+        putsRight(uitoa(bin ? 1 << (bin - 1) : 0), 8);
+        putcUart0('-');
+        putsColumn(uitoa(bin ? (1 << bin) - 1 : 0), 7);
+        for (i = 0; i < (bins[bin] * LATENCY_BAR + most - 1) / most; i++)
+            putcUart0('#');
+        putcUart0(' ');
+        putsUart0(uitoa(bins[bin]));
+    }
+}
+
+// for the shell's latency command, the last run once it is over
+void latencyPrint(void)
+{
+    putsUart0("latency ");
+    if (latencyRunning)
+    {
+        putsUart0("running, ");
+        putsUart0(uitoa(latencyLeft()));
+        putsUart0(" samples left");
+        return;
+    }
+    if (latencyTarget == 0)
+    {
+        putsUart0("no run yet");
+        return;
+    }
+    if (!latencySorted)
+    {
+        sortSamples(latencyIsr, latencyIsrCount);
+        sortSamples(latencyWake, latencyWakeCount);
+        latencySorted = true;
+    }
+    putsUart0(uitoa(latencyWakeCount));
+    putsUart0(" of ");
+    putsUart0(uitoa(latencyTarget));
+    putsUart0(" samples, ");
+    putsUart0(uitoa(LATENCY_PERIOD_US));
+    putsUart0(" us period, ");
+    putsUart0(uitoa(systemClockHz / 1000000));
+    putsUart0(" MHz, ");
+    putsUart0(uitoa(latencyMissed));
+    putsUart0(" missed, ");
+    putsUart0(uitoa(latencyOverruns));
+    putsUart0(" overruns");
+    printSamples("isr entry", latencyIsr, latencyIsrCount);
+    printSamples("task wake", latencyWake, latencyWakeCount);
+}
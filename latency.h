@@ -0,0 +1,79 @@
+// Interrupt Latency Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Latency Timer:
+//   Timer 3A periodic, interrupt priority 0 (CMSDK dual timer under QEMU)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               LATENCY RUN
+ * ==========================================================================
+ *  Timer 3A times out every LATENCY_PERIOD_US, a prime number of us so the
+ *  timeout walks across every phase of the tick, PendSV and the load.
+ *  The timer counts down from its reload value at the core clock, so
+ *  reload - count is how many cycles ago it timed out, read twice:
+ *
+ *  isr entry:   first thing timer3AIsr does, then it wakes the task
+ *               blocked on WAIT_LATENCY straight away (wakeWaiting)
+ *  task wake:   the latency task (Shell.c) reads it with latencySince()
+ *               as soon as it runs and hands it in with its next wait
+ *
+ *  a wake that was still busy when the timer timed out again, or that read
+ *  the count after it did, is an overrun: it took longer than a period.
+ *  The load task (Shell.c) churns the allocator, and with it the MPU
+ *  subregions, and writes to UART0 for as long as a run lasts. Between
+ *  runs it is blocked on WAIT_LOAD, latencyStart wakes it.
+ *
+ *  samples are cycles, saturated at 0xFFFF, in a kernel owned heap
+ *  allocation taken by the first run and kept for the report, which sorts
+ *  them for the percentiles and bins them by powers of 2
+ */
+
+#define LATENCY_SAMPLES     512         // per kind, 2 bytes each
+#define LATENCY_PERIOD_US   1303
+#define LATENCY_NONE        0xFFFFFFFF  // SVC_LATENCY_WAIT argument, no sample to hand in
+#define LATENCY_QUERY       0xFFFFFFFE  // SVC_LATENCY arguments, only samples left
+#define LATENCY_REPORT      0xFFFFFFFF  //   or print the last run as well
+#define LATENCY_BINS        17          // 0, 1, 2-3, ... 32768-65535
+
+extern uint16_t *latencyIsr;
+extern uint16_t *latencyWake;
+extern uint32_t latencyTarget;          // samples of each kind, 0 before the first run
+extern uint32_t latencyIsrCount;
+extern uint32_t latencyWakeCount;
+extern uint32_t latencyMissed;          // timeouts with no task waiting
+extern uint32_t latencyOverruns;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool latencyStart(uint32_t samples);
+void latencyStop(void);
+void latencyRetime(void);
+uint32_t latencyLeft(void);
+void latencyRecordWake(uint32_t cycles);
+uint32_t latencySince(void);
+void timer3AIsr(void);
+void latencyPrint(void);
+
+#endif
@@ -0,0 +1,113 @@
+// Deferred Log Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// UART Interface:
+//   records are sent as telemetry frames, see telemetry.h
+// Log records:
+// an ID from logfmt.h plus raw 32-bit arguments are queued in RAM, no string
+// is formatted on the target. tools/telemetry.py turns the frames back into
+// text using the same logfmt.h
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "asm.h"
+#include "log.h"
+#include "telemetry.h"
+
+#define LOG_MASK (LOG_WORDS - 1)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+uint32_t logBuffer[LOG_WORDS];
+volatile uint16_t logHead = 0;      // next word written by logEvent
+volatile uint16_t logTail = 0;      // next word sent by logFlush
+uint8_t  logSequence = 0;
+uint32_t logDropped = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// queues one record, safe from thread and handler mode (kernel only, the ring is in OS RAM)
+void logEvent(uint32_t header, uint32_t a, uint32_t b, uint32_t c)
+{
+    uint32_t argc = (header >> 16) & 0xFF;
+    uint32_t primask = enterCritical();
+    uint16_t head = logHead;
+
+    // drop the newest record instead of overwriting ones not sent yet
+    if (((head - logTail) & LOG_MASK) + argc + 1 > LOG_MASK)
+    {
+        logDropped++;
+        leaveCritical(primask);
+        return;
+    }
+
+    logBuffer[head] = header | ((uint32_t)logSequence++ << 24);
+    head = (head + 1) & LOG_MASK;
+    if (argc > 0) { logBuffer[head] = a; head = (head + 1) & LOG_MASK; }
+    if (argc > 1) { logBuffer[head] = b; head = (head + 1) & LOG_MASK; }
+    if (argc > 2) { logBuffer[head] = c; head = (head + 1) & LOG_MASK; }
+    logHead = head;
+
+    leaveCritical(primask);
+}
+
+bool logPending(void)
+{
+    return logHead != logTail || logDropped;
+}
+
+// sends every queued record as a TLM_LOG frame, call when the CPU has time to spare
+void logFlush(void)
+{
+    if (logDropped)
+    {
+        uint32_t primask = enterCritical();
+        uint32_t dropped = logDropped;
+        logDropped = 0;
+        leaveCritical(primask);
+        LOG1(LOG_DROPPED, dropped);
+    }
+
+    while (logTail != logHead)
+    {
+        uint16_t tail = logTail;
+        uint32_t header = logBuffer[tail];
+        uint32_t argc = (header >> 16) & 0xFF;
+        uint8_t payload[3 + 4 * LOG_MAX_ARGS];
+        uint8_t *p = payload;
+
+        *p++ = header >> 24;                // sequence
+        *p++ = header & 0xFF;               // id
+        *p++ = argc;
+
+        uint32_t i;
+        for (i = 0; i < argc; i++)
+        {
+            tail = (tail + 1) & LOG_MASK;
+            uint32_t word = logBuffer[tail];
+            *p++ = word & 0xFF;
+            *p++ = (word >> 8) & 0xFF;
+            *p++ = (word >> 16) & 0xFF;
+            *p++ = word >> 24;
+        }
+        logTail = (tail + 1) & LOG_MASK;    // release the slots before sending, the frame is a copy
+        tlmSendFrame(TLM_LOG, payload, p - payload);
+    }
+}
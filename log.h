@@ -0,0 +1,58 @@
+// Deferred Log Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// UART Interface:
+//   records are sent as telemetry frames, see telemetry.h
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "logfmt.h"
+
+/*
+ * ==========================================================================
+ *               LOG RECORD (RAM ring, 32-bit words)
+ * ==========================================================================
+ *  word 0       [31:24] sequence  [23:16] arg count  [7:0] LOG_ID
+ *  word 1..n    raw arguments
+ *
+ *  logFlush() sends each record as a TLM_LOG telemetry frame (telemetry.h),
+ *  the id goes out as one byte
+ */
+
+#define LOG_MAX_ARGS   3
+#define LOG_WORDS      64       // ring size in words, power of 2
+
+// fails to compile once logfmt.h has more ids than TLM_LOG's id byte holds
+typedef char LOG_ID_FITS_A_BYTE[LOG_ID_COUNT <= 256 ? 1 : -1];
+
+// a log call costs one function call and 1 + argc word stores
+#define LOG0(id)             logEvent(((uint32_t)0 << 16) | (id), 0, 0, 0)
+#define LOG1(id, a)          logEvent(((uint32_t)1 << 16) | (id), (uint32_t)(a), 0, 0)
+#define LOG2(id, a, b)       logEvent(((uint32_t)2 << 16) | (id), (uint32_t)(a), (uint32_t)(b), 0)
+#define LOG3(id, a, b, c)    logEvent(((uint32_t)3 << 16) | (id), (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void logEvent(uint32_t header, uint32_t a, uint32_t b, uint32_t c);
+bool logPending(void);
+void logFlush(void);
+
+#endif
@@ -0,0 +1,60 @@
+// Log Format Table
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// none, this file is also read by tools/logdecode.py on the host
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef LOGFMT_H_
+#define LOGFMT_H_
+
+/*
+ * Every deferred log message is one line of this table: X(ID, "format").
+ * The target only ever sees the ID (its position in the table), the host
+ * decoder parses this file to rebuild the string table, so:
+ *  - only append new lines, never reorder (IDs are positions)
+ *  - one X(...) per line, format on the same line
+ *  - formats use %u, %d and %x only, at most 3 arguments
+ */
+#define LOG_FORMATS(X) \
+    X(LOG_DROPPED,          "log: %u records dropped") \
+    X(LOG_MALLOC,           "malloc_heap: pid %u got %u blocks at %x") \
+    X(LOG_MALLOC_FAIL,      "malloc_heap: pid %u could not get %u bytes") \
+    X(LOG_FREE,             "free_heap: pid %u freed %u blocks at %x") \
+    X(LOG_FREE_REJECT,      "free_heap: pid %u not allowed to free %x") \
+    X(LOG_SRAM_SIZE,        "sram access window: size %u is not a multiple of 1024") \
+    X(LOG_SRAM_RANGE,       "sram access window: %x + %u is outside the heap") \
+    X(LOG_BUS_FAULT,        "bus fault in process %u") \
+    X(LOG_USAGE_FAULT,      "usage fault in process %u") \
+    X(LOG_HARD_FAULT,       "hard fault in process %u at pc %x, mfault %x") \
+    X(LOG_MPU_FAULT,        "mpu fault in process %u at pc %x, mfault %x") \
+    X(LOG_PENDSV,           "pendsv in process %u") \
+    X(LOG_PENDSV_MPU,       "pendsv in process %u called from MPU, mfault %x") \
+    X(LOG_MPU_KILL,         "mpu fault: killed process %u at pc %x, address %x") \
+    X(LOG_FAULT_RECOVERED,  "mpu fault: process %u running %u cycles after the fault") \
+    X(LOG_STACK_OVERFLOW,   "stack overflow: killed process %u at pc %x, sp %x") \
+    X(LOG_STACK_HIGH,       "stack: process %u used %u of %u bytes") \
+    X(LOG_STACK_GROW,       "stack: process %u grown to %u bytes, sp or access at %x") \
+    X(LOG_BUTTON_DROP,      "button: queue full, event %x dropped") \
+    X(LOG_CLOCK,            "clock: %u Hz, profile reached %u")
+
+#define LOG_ENUM(id, fmt) id,
+typedef enum _LOG_ID
+{
+    LOG_FORMATS(LOG_ENUM)
+    LOG_ID_COUNT
+} LOG_ID;
+#undef LOG_ENUM
+
+#endif
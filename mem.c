@@ -22,6 +22,8 @@
 #include "mpu.h"
 #include "isr.h"
 #include "uart0.h"
+#include "log.h"
+#include "trace.h"
 
 /*
  * ==========================================================================
@@ -47,7 +49,8 @@
 //-----------------------------------------------------------------------------
 
 extern uint32_t pid;
-uint64_t srdBitmask = 0x0000000000000000;
+uint64_t srdBitmask = 0x0000000000000000;    // SRD bits of the running process
+BLOCK blockArray[NUM_BLOCKS];
 
 //-----------------------------------------------------------------------------
 // Subroutines
@@ -56,7 +59,48 @@ uint64_t srdBitmask = 0x0000000000000000;
 // simple memory manager that allocates memory from the global heap
 void *malloc_heap (int size_in_bytes)
 {
-    if (!size_in_bytes || (size_in_bytes > 0x00002000)) return NULL;     // null if size zero or greater than a region
+    void *p = malloc_heap_for(size_in_bytes, pid, &srdBitmask);
+    if (p) applySramAccessMask(srdBitmask);
+    return p;
+}
+
+// i = 0->3 Region 0
+// i = 4->11 Region 1
+// i = 12->19 Region 2
+// i = 20->27 Region 3
+static int blockRegion(int i)
+{
+    if (i < 4) return 0;
+    return ((i - 4) / 8) + 1;
+}
+
+// populates the BLOCK table for blocks i.. and gives owner RW on them
+static void *claimBlocks(int i, int blocks, uint32_t owner, uint64_t *srdMask)
+{
+    int k;
+    for (k = i; k < i + blocks; k++)
+    {
+        blockArray[k].alloc = true;
+        blockArray[k].owner = owner;
+        blockArray[k].size = blocks;
+    }
+    // make those blocks have SRD bits 1 (RW access)
+    addSramAccessWindow(srdMask, SRAM_PTR(HEAP_START + (i * BLOCK_SIZE)), blocks * BLOCK_SIZE);
+    LOG3(LOG_MALLOC, owner, blocks, HEAP_START + (i * BLOCK_SIZE));
+    TRACE_POINT(TRACE_MALLOC_DONE, i);
+    return SRAM_PTR(HEAP_START + (i * BLOCK_SIZE)); // pointer to start address in mem
+}
+
+// allocates for any process, the kernel uses this for task stacks
+// srdMask is that process's saved mask, nothing is applied to the MPU here
+void *malloc_heap_for(int size_in_bytes, uint32_t owner, uint64_t *srdMask)
+{
+    TRACE_POINT(TRACE_MALLOC, size_in_bytes);
+    if (!size_in_bytes || (size_in_bytes > 0x00002000))                 // null if size zero or greater than a region
+    {
+        TRACE_POINT(TRACE_MALLOC_DONE, TRACE_NONE);
+        return NULL;
+    }
 
     int blocks = size_in_bytes / BLOCK_SIZE;
     if (size_in_bytes % BLOCK_SIZE > 0) blocks ++; // round up
@@ -67,54 +111,67 @@ void *malloc_heap (int size_in_bytes)
     {
         if (blockArray[i].alloc) continue; // skip used blocks
 
-        // i = 0->3 Region 0
-        // i = 4->11 Region 1
-        // i = 12->19 Region 2
-        // i = 20->27 Region 3
-        int startRegion = ((i - 4) / 8) + 1;
-        if (i < 4) startRegion = 0;
+        int startRegion = blockRegion(i);
         int freeCount = 1;
 
         // check subsequent blocks
         int j;
         for (j = i + 1; j < NUM_BLOCKS && freeCount < blocks; j++)
         {
-            int jregion = ((j - 4) / 8) + 1;
-            if (j < 4) jregion = 0;
             // stop if block isnt free or crosses region boundary
-            if (blockArray[j].alloc || jregion != startRegion) break;
+            if (blockArray[j].alloc || blockRegion(j) != startRegion) break;
             freeCount++;
         }
 
         if (freeCount == blocks)
-        {
-            // populate BLOCK table
-            int k;
-            for (k = i; k < i + blocks; k++)
-            {
-                blockArray[k].alloc = true;
-                blockArray[k].owner = pid;
-                blockArray[k].size = blocks;
-            }
-            // make those blocks have SRD bits 1 (RW access)
-            addSramAccessWindow(&srdBitmask, (void *)(HEAP_START + (i * BLOCK_SIZE)), blocks * BLOCK_SIZE);
-            applySramAccessMask(srdBitmask);
-            //putsUart0(inttohex(srdBitmask));
-            return (void *)(HEAP_START + (i * BLOCK_SIZE)); // pointer to start address in mem
-        }
+            return claimBlocks(i, blocks, owner, srdMask);
 
         i += freeCount - 1; // if blocks not found, skip ahead to past the checked blocks
     }
+    LOG2(LOG_MALLOC_FAIL, owner, size_in_bytes);
+    TRACE_POINT(TRACE_MALLOC_DONE, TRACE_NONE);
     return NULL; // failed to find space
 }
 
+// same, but the highest free run of blocks: a stack that grows (growStack)
+// finds the blocks below it free while first fit fills the heap from 0
+void *malloc_heap_top_for(int size_in_bytes, uint32_t owner, uint64_t *srdMask)
+{
+    TRACE_POINT(TRACE_MALLOC, size_in_bytes);
+    if (!size_in_bytes || (size_in_bytes > 0x00002000))
+    {
+        TRACE_POINT(TRACE_MALLOC_DONE, TRACE_NONE);
+        return NULL;
+    }
+
+    int blocks = size_in_bytes / BLOCK_SIZE;
+    if (size_in_bytes % BLOCK_SIZE > 0) blocks ++; // round up
+
+    int i, j;
+    for (i = NUM_BLOCKS - blocks; i >= 0; i--)
+    {
+        for (j = i; j < i + blocks && !blockArray[j].alloc && blockRegion(j) == blockRegion(i); j++);
+        if (j == i + blocks)
+            return claimBlocks(i, blocks, owner, srdMask);
+    }
+    LOG2(LOG_MALLOC_FAIL, owner, size_in_bytes);
+    TRACE_POINT(TRACE_MALLOC_DONE, TRACE_NONE);
+    return NULL;
+}
+
 // deallocates the memory from the heap
 void free_heap(void * p)
 {
-    int blockIndex = ((uint32_t)p - HEAP_START) / BLOCK_SIZE;
+    int blockIndex = (SRAM_ADDR(p) - HEAP_START) / BLOCK_SIZE;
 
     if (blockIndex < 0 || blockIndex >= NUM_BLOCKS) return; // check if bad pointer, out of heap range
-    if (blockArray[blockIndex].owner != pid || !blockArray[blockIndex].alloc) return; // not the owner of the memory or not allocated anyways
+    TRACE_POINT(TRACE_FREE, blockIndex);
+    if (blockArray[blockIndex].owner != pid || !blockArray[blockIndex].alloc) // not the owner of the memory or not allocated anyways
+    {
+        LOG2(LOG_FREE_REJECT, pid, SRAM_ADDR(p));
+        TRACE_POINT(TRACE_FREE_DONE, 0);
+        return;
+    }
 
     int size = blockArray[blockIndex].size;
 
@@ -130,8 +187,58 @@ void free_heap(void * p)
         // set that block to 0 in srdBitmask
         srdBitmask &= ~((uint64_t)(1 << (i + 4))); // makes 0 no RW access for unpriv
     }
-    //putsUart0(inttohex(srdBitmask));
     applySramAccessMask(srdBitmask);
+    LOG3(LOG_FREE, pid, size, SRAM_ADDR(p));
+    TRACE_POINT(TRACE_FREE_DONE, 0);
+}
+
+// frees every block of a process that is being killed, returns the number of blocks
+// srdMask is that process's saved mask, the caller applies it if the process is running
+int free_heap_owner(uint32_t owner, uint64_t *srdMask)
+{
+    int i, count = 0;
+    for (i = 0; i < NUM_BLOCKS; i++)
+    {
+        if (!blockArray[i].alloc || blockArray[i].owner != owner) continue;
+        blockArray[i].alloc = false;
+        blockArray[i].owner = 0;
+        blockArray[i].size = 0;
+        *srdMask &= ~((uint64_t)1 << (i + 4));
+        count++;
+    }
+    if (count) LOG3(LOG_FREE, owner, count, 0);
+    return count;
+}
+
+// the free block right below the allocation at p joins it as its new first
+// block, SRD bits are left to the caller (a stack growing into its guard)
+bool grow_heap_down(void *p, uint32_t owner)
+{
+    int first = (SRAM_ADDR(p) - HEAP_START) / BLOCK_SIZE;
+    int size, k;
+
+    if (SRAM_ADDR(p) < HEAP_START + BLOCK_SIZE || first >= NUM_BLOCKS) return false;
+    if (!blockArray[first].alloc || blockArray[first].owner != owner || blockArray[first - 1].alloc)
+        return false;
+
+    size = blockArray[first].size + 1;
+    for (k = first - 1; k < first - 1 + size; k++)
+    {
+        blockArray[k].alloc = true;
+        blockArray[k].owner = owner;
+        blockArray[k].size = size;
+    }
+    LOG3(LOG_MALLOC, owner, 1, SRAM_ADDR(p) - BLOCK_SIZE);
+    return true;
+}
+
+// blocks held by a process, stacks included
+int heapBlocksOwned(uint32_t owner)
+{
+    int i, count = 0;
+    for (i = 0; i < NUM_BLOCKS; i++)
+        if (blockArray[i].alloc && blockArray[i].owner == owner) count++;
+    return count;
 }
 
 void dumpHeap(void)
@@ -64,20 +64,38 @@ typedef struct _BLOCK
 
 #define NUM_BLOCKS  (HEAP_SIZE / BLOCK_SIZE) //32 blocks
 
+#define SRAM_BASE   0x20000000
 #define HEAP_START  0x20001000 // note: 0x20000000 -> 0x20001000 is for OS
 #define HEAP_END    0x20008000
 #define HEAP_SIZE   0x7000
 #define BLOCK_SIZE  1024
 #define NUM_BLOCKS  (HEAP_SIZE / BLOCK_SIZE) // heap is 32 but 28 usable
 
-BLOCK blockArray[NUM_BLOCKS];
+// SRAM pointer <-> the 32 bit address the MPU and the log see. The same value
+// on the target; the host build (-DHOST_SIM) keeps the SRAM in hostSram
+// (host/stubs.c) and maps offsets from SRAM_BASE onto it
+#ifndef HOST_SIM
+#define SRAM_PTR(address)   ((void *)(address))
+#define SRAM_ADDR(p)        ((uint32_t)(p))
+#else
+extern uint8_t hostSram[HEAP_END - SRAM_BASE];
+#define SRAM_PTR(address)   ((void *)(hostSram + ((address) - SRAM_BASE)))
+#define SRAM_ADDR(p)        ((uint32_t)(SRAM_BASE + ((uintptr_t)(p) - (uintptr_t)hostSram)))
+#endif
+
+extern BLOCK blockArray[NUM_BLOCKS];
 
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
 void *malloc_heap (int size_in_bytes);
+void *malloc_heap_for(int size_in_bytes, uint32_t owner, uint64_t *srdMask);
+void *malloc_heap_top_for(int size_in_bytes, uint32_t owner, uint64_t *srdMask);
+bool grow_heap_down(void *p, uint32_t owner);
 void free_heap(void * p);
+int free_heap_owner(uint32_t owner, uint64_t *srdMask);
+int heapBlocksOwned(uint32_t owner);
 void dumpHeap(void);
 
 #endif
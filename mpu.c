@@ -21,9 +21,12 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "tm4c123gh6pm.h"
+#include "mpuhw.h"
 #include "mpu.h"
+#include "mem.h"
 #include "isr.h"
 #include "uart0.h"
+#include "log.h"
 
 //-----------------------------------------------------------------------------
 // Global variables
@@ -90,6 +93,19 @@ void setupSramAccess(void)
     NVIC_MPU_ATTR_R &= ~(0xFF << 8); // enable region initially
 }
 
+// kernel data that tasks read without a syscall (timebase.h), RW for priv,
+// R for unpriv. size is a power of 2 from 32 bytes and base is aligned to it
+void allowSharedRead(volatile void *base, uint32_t size)
+{
+    uint32_t n = 4;                                 // size = 2^(SIZE+1)
+
+    while ((2u << n) < size)
+        n++;
+    NVIC_MPU_NUMBER_R = 7;                          // highest region, wins over the OS RAM rule
+    NVIC_MPU_BASE_R = SRAM_ADDR(base);
+    NVIC_MPU_ATTR_R |= NVIC_MPU_ATTR_ENABLE | (n << 1) | (0b010 << 24) | (1 << 28);
+}
+
 uint64_t createSramAccessMask(void)
 {
     // returns value of srd bits to allow access to SRAM
@@ -120,27 +136,54 @@ void applySramAccessMask(uint64_t srdBitMask)
 // adds access to the requested SRAM address range
 void addSramAccessWindow(uint64_t *srdBitMask, uint32_t *baseAdd, uint32_t size_in_bytes)
 {
+    uint32_t base = SRAM_ADDR(baseAdd);
+
     if (size_in_bytes % 1024 != 0)
     {
-        putsUart0("sram access window: size is wrong\n");
-      return;
+        LOG1(LOG_SRAM_SIZE, size_in_bytes);
+        return;
     }
-    if ((uint32_t)baseAdd < 0x20001000 || (uint32_t)baseAdd + size_in_bytes > 0x20008000)
+    if (base < 0x20001000 || base + size_in_bytes > 0x20008000)
     {
-        putsUart0("sram access window: incorrect range\n");
+        LOG2(LOG_SRAM_RANGE, base, size_in_bytes);
         return;
     }
 
-    uint32_t start = ((uint32_t)baseAdd - 0x20000000) >> 10;                     // start subregion (find offset and divide)
-    uint32_t end   = ((uint32_t)baseAdd - 0x20000000 + size_in_bytes) >> 10; // end subregion
+    uint32_t start = (base - 0x20000000) >> 10;                 // start subregion (find offset and divide)
+    uint32_t end   = (base - 0x20000000 + size_in_bytes) >> 10; // end subregion
 
-    int i;
+    uint32_t i;
     for (i = start; i < end; i++)
     {
         *srdBitMask |= (uint64_t) 1 << i; // turns bit on at that subregion, gets RW access
     }
 }
 
+// takes away access to an SRAM address range, same rules as addSramAccessWindow
+void removeSramAccessWindow(uint64_t *srdBitMask, uint32_t *baseAdd, uint32_t size_in_bytes)
+{
+    uint32_t base = SRAM_ADDR(baseAdd);
+
+    if (size_in_bytes % 1024 != 0)
+    {
+        LOG1(LOG_SRAM_SIZE, size_in_bytes);
+        return;
+    }
+    if (base < 0x20001000 || base + size_in_bytes > 0x20008000)
+    {
+        LOG2(LOG_SRAM_RANGE, base, size_in_bytes);
+        return;
+    }
+
+    uint32_t start = (base - 0x20000000) >> 10;
+    uint32_t end   = (base - 0x20000000 + size_in_bytes) >> 10;
+
+    uint32_t i;
+    for (i = start; i < end; i++)
+    {
+        *srdBitMask &= ~((uint64_t) 1 << i); // turns bit off, back to the region rule
+    }
+}
 
 /* NOTES TO SELF
  *
@@ -33,8 +33,10 @@ void setBackgroundRule(void);
 void allowFlashAccess(void);
 void allowPeripheralAccess(void);
 void setupSramAccess(void);
+void allowSharedRead(volatile void *base, uint32_t size);
 uint64_t createSramAccessMask(void);
 void applySramAccessMask(uint64_t srdBitMask);
 void addSramAccessWindow(uint64_t *srdBitMask, uint32_t *baseAdd, uint32_t size_in_bytes);
+void removeSramAccessWindow(uint64_t *srdBitMask, uint32_t *baseAdd, uint32_t size_in_bytes);
 
 #endif
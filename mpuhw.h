@@ -0,0 +1,30 @@
+// MPU Register Access
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// MPU:
+//   NVIC_MPU_NUMBER_R, NVIC_MPU_BASE_R, NVIC_MPU_ATTR_R, NVIC_MPU_CTRL_R
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef MPUHW_H_
+#define MPUHW_H_
+
+// include after tm4c123gh6pm.h. On the target the MPU registers are the ones
+// in the device header; the Linux build (host/Makefile, -DHOST_SIM) points
+// the same names at a simulated MPU that checks every access
+#ifdef HOST_SIM
+#include "host/mpusim.h"
+#endif
+
+#endif
@@ -0,0 +1,179 @@
+// PC Sampling Profiler Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Sample Timer:
+//   Timer 2A periodic at profileRate, its interrupt enters through profileISR
+//   (asm.s). QEMU has no Timer 2, CMSDK Timer 1 counts down in its place
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "isr.h"
+#include "uart0.h"
+#include "mem.h"
+#include "clock.h"
+#include "profile.h"
+
+#ifndef QEMU_MPS2
+#define IRQ_SAMPLE          (INT_TIMER2A - 16)
+#else
+#define CMSDK_TIMER1_CTRL_R     (*((volatile uint32_t *)0x40001000))
+#define CMSDK_TIMER1_RELOAD_R   (*((volatile uint32_t *)0x40001008))
+#define CMSDK_TIMER1_INT_R      (*((volatile uint32_t *)0x4000100C))  // write 1 to clear
+#define CMSDK_CTRL_ENABLE       0x00000001
+#define CMSDK_CTRL_IRQEN        0x00000008
+#define IRQ_SAMPLE          9
+#endif
+
+#define FRAME_PC            6               // r0 r1 r2 r3 r12 lr pc xpsr
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+extern uint32_t pid;
+
+PROFILE_SLOT *profileTable = NULL;
+uint32_t profileRate = 0;
+uint32_t profileSamples = 0;
+uint32_t profileDropped = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void sampleTimerLoad(void)
+{
+#ifndef QEMU_MPS2
+    TIMER2_TAILR_R = systemClockHz / profileRate - 1;
+#else
+    CMSDK_TIMER1_RELOAD_R = systemClockHz / profileRate - 1;
+#endif
+}
+
+static void sampleTimerStop(void)
+{
+#ifndef QEMU_MPS2
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;
+#else
+    CMSDK_TIMER1_CTRL_R = 0;
+#endif
+}
+
+// a new histogram each time, hz is clamped to 1..PROFILE_MAX_HZ
+bool profileStart(uint32_t hz)
+{
+    uint64_t srd = 0;
+    uint32_t i;
+
+    if (profileTable == NULL)
+        profileTable = malloc_heap_for(PROFILE_SLOTS * sizeof(PROFILE_SLOT), 0, &srd);
+    if (profileTable == NULL) return false;
+
+    sampleTimerStop();
+    for (i = 0; i < PROFILE_SLOTS; i++)
+    {
+        profileTable[i].pc = 0;
+        profileTable[i].count = 0;
+    }
+    profileSamples = profileDropped = 0;
+    profileRate = hz == 0 ? 1 : hz > PROFILE_MAX_HZ ? PROFILE_MAX_HZ : hz;
+
+#ifndef QEMU_MPS2
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;
+    _delay_cycles(3);
+    TIMER2_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER2_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    sampleTimerLoad();
+    TIMER2_IMR_R = TIMER_IMR_TATOIM;
+    TIMER2_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER2_CTL_R |= TIMER_CTL_TAEN;
+#else
+    sampleTimerLoad();
+    CMSDK_TIMER1_INT_R = 1;
+    CMSDK_TIMER1_CTRL_R = CMSDK_CTRL_ENABLE | CMSDK_CTRL_IRQEN;
+#endif
+    (&NVIC_EN0_R)[IRQ_SAMPLE >> 5] = 1 << (IRQ_SAMPLE & 31);
+    return true;
+}
+
+// the histogram stays for tlm profile
+void profileStop(void)
+{
+    sampleTimerStop();
+    profileRate = 0;
+}
+
+// the system clock changed (kernel.c retimeClock)
+void profileRetime(void)
+{
+    if (profileRate)
+        sampleTimerLoad();
+}
+
+// one sample, the frame is whatever the timer interrupted
+void profileSample(uint32_t *frame)
+{
+    uint32_t pc = frame[FRAME_PC];
+    uint32_t slot = ((pc >> 1) * 2654435761u) >> 24;    // Fibonacci hash, top bits
+    uint8_t probe;
+
+#ifndef QEMU_MPS2
+    TIMER2_ICR_R = TIMER_ICR_TATOCINT;
+#else
+    CMSDK_TIMER1_INT_R = 1;
+#endif
+    profileSamples++;
+    for (probe = 0; probe < PROFILE_PROBES; probe++)
+    {
+        PROFILE_SLOT *s = &profileTable[(slot + probe) & (PROFILE_SLOTS - 1)];
+        if (s->pc == 0)
+        {
+            s->pc = pc;
+            s->pid = pid;
+        }
+        else if (s->pc != pc || s->pid != (uint16_t)pid)
+            continue;
+        if (s->count != 0xFFFF)
+            s->count++;
+        return;
+    }
+    profileDropped++;
+}
+
+void profilePrint(void)
+{
+    uint32_t i, used = 0;
+
+    if (profileTable != NULL)
+        for (i = 0; i < PROFILE_SLOTS; i++)
+            if (profileTable[i].pc) used++;
+    putsUart0("profile ");
+    if (profileRate)
+    {
+        putsUart0("on at ");
+        putsUart0(uitoa(profileRate));
+        putsUart0(" Hz, ");
+    }
+    else
+        putsUart0("off, ");
+    putsUart0(uitoa(profileSamples));
+    putsUart0(" samples, ");
+    putsUart0(uitoa(profileDropped));
+    putsUart0(" dropped, ");
+    putsUart0(uitoa(used));
+    putsUart0(" pcs");
+}
@@ -0,0 +1,72 @@
+// PC Sampling Profiler Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Sample Timer:
+//   Timer 2A periodic, interrupt priority 0 (CMSDK Timer 1 under QEMU)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               PC SAMPLING
+ * ==========================================================================
+ *  profileISR:     (asm.s) finds the exception frame like the fault entries
+ *                  and hands it to profileSample
+ *  profileSample:  the stacked pc and the running pid are one histogram key,
+ *                  hashed into PROFILE_SLOTS slots, PROFILE_PROBES tries
+ *                  before the sample counts as dropped
+ *  tlm profile:    TLM_PROFILE frames (telemetry.h), tools/pcprofile.py adds
+ *                  them up per function from the ELF symbol table
+ *
+ *  the histogram is a kernel owned heap allocation, taken by the first
+ *  profile start and kept for the dump. Priority 0 preempts the kernel, so
+ *  SVC, SysTick and PendSV time shows up too, only the other priority 0
+ *  handlers (UARTs, buttons, faults) can't be sampled
+ */
+
+#define PROFILE_SLOTS   256             // power of 2, 8 bytes each
+#define PROFILE_PROBES  8
+#define PROFILE_HZ      10000           // rate of profile start without one
+#define PROFILE_MAX_HZ  50000
+#define PROFILE_STATUS  0xFFFFFFFF      // SVC_PROFILE argument, only print
+
+typedef struct _PROFILE_SLOT
+{
+    uint32_t pc;                        // 0 when unused
+    uint16_t pid;
+    uint16_t count;                     // saturates at 0xFFFF
+} PROFILE_SLOT;
+
+extern PROFILE_SLOT *profileTable;
+extern uint32_t profileRate;            // Hz, 0 while stopped
+extern uint32_t profileSamples;
+extern uint32_t profileDropped;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool profileStart(uint32_t hz);
+void profileStop(void);
+void profileRetime(void);
+void profileSample(uint32_t *frame);
+void profilePrint(void);
+
+#endif
@@ -0,0 +1,34 @@
+// Push Button Library (QEMU port)
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: QEMU mps2-an386
+// Target uC:       Cortex-M4F
+// System Clock:    -
+
+// Hardware configuration:
+// Push Buttons:
+//   the MPS2 has no pin interrupts and no Timer 1, the queue stays empty and
+//   the buttons task sleeps for good. Replaces button.c
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initButtons(void) {}
+
+bool getButtonEvent(uint8_t *event)
+{
+    return false;
+}
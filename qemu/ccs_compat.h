@@ -0,0 +1,46 @@
+// CCS Compatibility
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: QEMU mps2-an386
+// Target uC:       Cortex-M4F
+// System Clock:    25 MHz
+
+// Hardware configuration:
+// GCC build:
+//   force included (-include) into every file of the QEMU build, stands in
+//   for the TI compiler intrinsics the board code uses
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef CCS_COMPAT_H_
+#define CCS_COMPAT_H_
+
+#include <stdint.h>
+
+// only used for the few cycles a peripheral needs after its clock is enabled
+static inline void _delay_cycles(uint32_t cycles)
+{
+    while (cycles--)
+        __asm volatile ("nop");
+}
+
+// PRIMASK before, then interrupts masked (trace.h)
+static inline uint32_t _disable_interrupts(void)
+{
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n    cpsid i" : "=r" (primask) : : "memory");
+    return primask;
+}
+
+static inline void _restore_interrupts(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+#endif
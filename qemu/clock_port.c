@@ -0,0 +1,47 @@
+// Clock Library (QEMU port)
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: QEMU mps2-an386
+// Target uC:       Cortex-M4F
+// System Clock:    25 MHz
+
+// Hardware configuration:
+// the MPS2 has no RCC or PLL, SYSCLK is a fixed 25 MHz (KERNEL_FCYC in the
+// Makefile), so no profile can be reached and systemClockHz never changes.
+// Replaces clock.c
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "clock.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const uint32_t profileHz[CLOCK_PROFILES] = {16000000, 40000000, 80000000};
+
+uint32_t systemClockHz = KERNEL_FCYC;
+CLOCK_PROFILE clockProfile = CLOCK_PROFILES;   // none of them
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint32_t clockProfileHz(CLOCK_PROFILE profile)
+{
+    return profile < CLOCK_PROFILES ? profileHz[profile] : 0;
+}
+
+// the clock can't change, the caller keeps systemClockHz
+bool setSystemClock(CLOCK_PROFILE profile)
+{
+    return false;
+}
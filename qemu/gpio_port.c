@@ -0,0 +1,114 @@
+// GPIO Library (QEMU port)
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: QEMU mps2-an386
+// Target uC:       Cortex-M4F
+// System Clock:    -
+
+// Hardware configuration:
+// FPGA IO:
+//   LED register (0x40028000) bit 0 stands in for the blue LED (PF2)
+//   BUTTON register (0x40028008) bits 0-1 stand in for PB0/PB1
+// the TM4C GPIO ports do not exist on the MPS2 and any access would bus
+// fault, so pin setup is a no-op and only the data calls touch the FPGA IO.
+// Replaces gpio.c
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+
+#define FPGAIO_LED_R    (*((volatile uint32_t *)0x40028000))
+#define FPGAIO_BUTTON_R (*((volatile uint32_t *)0x40028008))
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// FPGA IO bit of a board pin, -1 if the MPS2 has nothing for it
+static int8_t ledBit(PORT port, uint8_t pin)
+{
+    if (port == PORTF && pin == 2) return 0;
+    return -1;
+}
+
+static int8_t buttonBit(PORT port, uint8_t pin)
+{
+    if (port == PORTF && pin == 3) return 0;
+    if (port == PORTC && pin == 4) return 1;
+    return -1;
+}
+
+void applyPinConfig(const PIN_CONFIG pins[], uint8_t count) {}
+
+void enablePort(PORT port) {}
+void disablePort(PORT port) {}
+
+void selectPinPushPullOutput(PORT port, uint8_t pin) {}
+void selectPinOpenDrainOutput(PORT port, uint8_t pin) {}
+void selectPinDigitalInput(PORT port, uint8_t pin) {}
+void selectPinAnalogInput(PORT port, uint8_t pin) {}
+void setPinCommitControl(PORT port, uint8_t pin) {}
+
+void enablePinPullup(PORT port, uint8_t pin) {}
+void disablePinPullup(PORT port, uint8_t pin) {}
+void enablePinPulldown(PORT port, uint8_t pin) {}
+void disablePinPulldown(PORT port, uint8_t pin) {}
+
+void setPinAuxFunction(PORT port, uint8_t pin, uint32_t fn) {}
+
+void selectPinInterruptRisingEdge(PORT port, uint8_t pin) {}
+void selectPinInterruptFallingEdge(PORT port, uint8_t pin) {}
+void selectPinInterruptBothEdges(PORT port, uint8_t pin) {}
+void selectPinInterruptHighLevel(PORT port, uint8_t pin) {}
+void selectPinInterruptLowLevel(PORT port, uint8_t pin) {}
+void enablePinInterrupt(PORT port, uint8_t pin) {}
+void disablePinInterrupt(PORT port, uint8_t pin) {}
+void clearPinInterrupt(PORT port, uint8_t pin) {}
+
+void setPinValue(PORT port, uint8_t pin, bool value)
+{
+    int8_t bit = ledBit(port, pin);
+    if (bit < 0) return;
+    if (value)
+        FPGAIO_LED_R |= 1 << bit;
+    else
+        FPGAIO_LED_R &= ~(1 << bit);
+}
+
+void togglePinValue(PORT port, uint8_t pin)
+{
+    int8_t bit = ledBit(port, pin);
+    if (bit >= 0)
+        FPGAIO_LED_R ^= 1 << bit;
+}
+
+// the board buttons pull low when pressed, the FPGA IO reads 1
+bool getPinValue(PORT port, uint8_t pin)
+{
+    int8_t bit = ledBit(port, pin);
+    if (bit >= 0) return (FPGAIO_LED_R >> bit) & 1;
+    bit = buttonBit(port, pin);
+    if (bit >= 0) return !((FPGAIO_BUTTON_R >> bit) & 1);
+    return false;
+}
+
+void setPortValue(PORT port, uint8_t value) {}
+
+void setPortMasked(PORT port, uint8_t mask, uint8_t value)
+{
+    if (mask & (1 << 2))
+        setPinValue(port, 2, (value >> 2) & 1);
+}
+
+uint8_t getPortValue(PORT port)
+{
+    return 0;
+}
@@ -0,0 +1,41 @@
+// C Library (QEMU port)
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: QEMU mps2-an386
+// Target uC:       Cortex-M4F
+// System Clock:    -
+
+// Hardware configuration:
+// newlib's atoi goes through strtol and reads _impure_ptr, a global in OS
+// RAM, so an unprivileged shell calling it takes an MPU fault. The TI
+// library's atoi keeps no state. Linking this one first keeps newlib's out
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int atoi(const char *str)
+{
+    int value = 0;
+    bool negative;
+
+    while (*str == ' ' || *str == '\t')
+        str++;
+    negative = (*str == '-');
+    if (*str == '-' || *str == '+')
+        str++;
+    while (*str >= '0' && *str <= '9')
+        value = value * 10 + (*str++ - '0');
+    return negative ? -value : value;
+}
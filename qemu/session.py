@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+# Scripted shell sessions on QEMU
+# Angelina Abuhilal
+#
+# Boots rtos.elf under qemu-system-arm, types each command of a session
+# script into UART0 and checks what comes back before the next prompt.
+# Telemetry frames in the output are decoded the same way tools/telemetry.py
+# does, so checks can match the decoded records.
+#
+# Script lines:
+#   command         typed followed by Enter, waits for the next "> "
+#   ? text          the last command's output contains text
+#   ! text          the last command's output does not contain text
+#   ~ regex         the last command's output matches the regular expression
+#   # comment
+#
+# Fault reports ("... fault in process") fail the session unless a ? line
+# expects them. Exits non-zero on the first failure or timeout.
+#
+#   python3 qemu/session.py sessions/smoke.txt
+#   python3 qemu/session.py -v --timeout 20 sessions/*.txt
+
+import argparse
+import io
+import os
+import queue
+import re
+import shlex
+import subprocess
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'tools'))
+import logdecode                    # noqa: E402
+from telemetry import TelemetryReader  # noqa: E402
+
+PROMPT = '> '
+FAULT = 'fault in process'
+DEFAULT_QEMU = 'qemu-system-arm -M mps2-an386 -nographic -kernel rtos.elf'
+
+
+class SessionError(Exception):
+    pass
+
+
+class Target:
+    """QEMU with UART0 on its stdio, output decoded into text as it arrives."""
+
+    def __init__(self, command, formats, verbose):
+        self.proc = subprocess.Popen(shlex.split(command), stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        self.bytes = queue.Queue()
+        self.text = io.StringIO()
+        self.reader = TelemetryReader(self.text, formats)
+        self.verbose = verbose
+        self.seen = 0
+        threading.Thread(target=self.pump, daemon=True).start()
+
+    def pump(self):
+        while True:
+            chunk = self.proc.stdout.read1(256)
+            if not chunk:
+                self.bytes.put(None)
+                return
+            self.bytes.put(chunk)
+
+    def send(self, line):
+        self.proc.stdin.write(line.encode('ascii') + b'\r')
+        self.proc.stdin.flush()
+
+    # everything since the last call, up to and including the next prompt
+    def until_prompt(self, timeout):
+        deadline = time.monotonic() + timeout
+        while True:
+            text = self.text.getvalue()
+            end = text.find(PROMPT, self.seen)
+            if end >= 0:
+                out = text[self.seen:end]
+                self.seen = end + len(PROMPT)
+                return out
+            left = deadline - time.monotonic()
+            if left <= 0:
+                raise SessionError('timeout, no prompt after:\n' + text[self.seen:])
+            try:
+                chunk = self.bytes.get(timeout=left)
+            except queue.Empty:
+                continue
+            if chunk is None:
+                raise SessionError('qemu exited:\n' + text[self.seen:])
+            for byte in chunk:
+                self.reader.feed(byte)
+            if self.verbose:
+                sys.stdout.write(self.text.getvalue()[len(text):])
+                sys.stdout.flush()
+
+    def close(self):
+        self.proc.kill()
+        self.proc.wait()
+
+
+def check(command, out, expects, rejects, patterns):
+    for text in expects:
+        if text not in out:
+            raise SessionError('"%s": expected "%s" in:\n%s' % (command, text, out))
+    for pattern in patterns:
+        if not re.search(pattern, out):
+            raise SessionError('"%s": expected a match for "%s" in:\n%s' % (command, pattern, out))
+    for text in rejects:
+        if text in out:
+            raise SessionError('"%s": unexpected "%s" in:\n%s' % (command, text, out))
+    if FAULT in out and not any(FAULT in text for text in expects):
+        raise SessionError('"%s": fault:\n%s' % (command, out))
+
+
+def run_session(path, args, formats):
+    with open(path) as f:
+        lines = [line.rstrip('\n') for line in f]
+
+    target = Target(args.qemu, formats, args.verbose)
+    try:
+        target.until_prompt(args.timeout)           # banner and first prompt
+        command, expects, rejects, patterns = None, [], [], []
+        for line in lines + [None]:
+            if line is not None and (not line.strip() or line.lstrip().startswith('#')):
+                continue
+            if line is not None and line[:2] in ('? ', '! ', '~ '):
+                {'?': expects, '!': rejects, '~': patterns}[line[0]].append(line[2:])
+                continue
+            if command is not None:
+                check(command, out, expects, rejects, patterns)
+            if line is None:
+                break
+            command, expects, rejects, patterns = line, [], [], []
+            target.send(command)
+            out = target.until_prompt(args.timeout)
+    finally:
+        target.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run scripted shell sessions on QEMU')
+    parser.add_argument('scripts', nargs='+')
+    parser.add_argument('--qemu', default=DEFAULT_QEMU, help='command line that boots the image')
+    parser.add_argument('--formats', default=logdecode.DEFAULT_FORMATS, help='path to logfmt.h')
+    parser.add_argument('--timeout', type=float, default=10, help='seconds to wait for a prompt')
+    parser.add_argument('-v', '--verbose', action='store_true', help='echo the console')
+    args = parser.parse_args()
+
+    formats = logdecode.load_formats(args.formats)
+    failed = 0
+    for path in args.scripts:
+        try:
+            run_session(path, args, formats)
+            print('PASS %s' % path)
+        except SessionError as e:
+            print('FAIL %s: %s' % (path, e))
+            failed += 1
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,154 @@
+//*****************************************************************************
+//
+// Startup code for the QEMU mps2-an386 (Cortex-M4F) build, GCC version of
+// tm4c123gh6pm_startup_ccs.c
+//
+// The kernel, shell and fault handlers are the board's own, only the IRQ
+// numbers differ: the CMSDK UARTs have separate rx and tx interrupts, both
+// go to the same uartNIsr.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <string.h>
+
+//*****************************************************************************
+//
+// Forward declaration of the default fault handlers.
+//
+//*****************************************************************************
+void ResetISR(void);
+static void NmiSR(void);
+static void IntDefaultHandler(void);
+
+extern int main(void);
+
+extern void busFaultISR(void);
+extern void usageFaultISR(void);
+extern void hardFaultISR(void);
+extern void mpuFaultISR(void);
+extern void pendsvISR(void);
+extern void svcISR(void);
+extern void systickISR(void);
+extern void uart0Isr(void);
+extern void uart1Isr(void);
+extern void uart2Isr(void);
+extern void uart3Isr(void);
+extern void uart4Isr(void);
+extern void timeBaseIsr(void);
+extern void profileISR(void);
+extern void timer3AIsr(void);
+
+//*****************************************************************************
+//
+// Linker symbols (mps2_an386.ld): top of the main stack and the load and run
+// addresses of the initialized data.
+//
+//*****************************************************************************
+extern uint32_t __STACK_TOP;
+extern uint32_t __data_load__;
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+
+#define CPACR_R (*((volatile uint32_t *)0xE000ED88))
+
+//*****************************************************************************
+//
+// The vector table, placed at 0x0000.0000 by the linker script.
+//
+//*****************************************************************************
+__attribute__((section(".intvecs"), used))
+void (* const g_pfnVectors[])(void) =
+{
+    (void (*)(void))((uint32_t)&__STACK_TOP),
+                                            // The initial stack pointer
+    ResetISR,                               // The reset handler
+    NmiSR,                                  // The NMI handler
+    hardFaultISR,                           // The hard fault handler
+    mpuFaultISR,                            // The MPU fault handler
+    busFaultISR,                            // The bus fault handler
+    usageFaultISR,                          // The usage fault handler
+    0,                                      // Reserved
+    0,                                      // Reserved
+    0,                                      // Reserved
+    0,                                      // Reserved
+    svcISR,                                 // SVCall handler
+    IntDefaultHandler,                      // Debug monitor handler
+    0,                                      // Reserved
+    pendsvISR,                              // The PendSV handler
+    systickISR,                             // The SysTick handler
+    uart0Isr,                               // 0  UART0 Rx
+    uart0Isr,                               // 1  UART0 Tx
+    uart1Isr,                               // 2  UART1 Rx
+    uart1Isr,                               // 3  UART1 Tx
+    uart2Isr,                               // 4  UART2 Rx
+    uart2Isr,                               // 5  UART2 Tx
+    IntDefaultHandler,                      // 6  GPIO 0 combined
+    IntDefaultHandler,                      // 7  GPIO 1 combined
+    timeBaseIsr,                            // 8  Timer 0
+    profileISR,                             // 9  Timer 1
+    timer3AIsr,                             // 10 Dual timer
+    IntDefaultHandler,                      // 11 SPI
+    IntDefaultHandler,                      // 12 UART 0-4 overflow
+    IntDefaultHandler,                      // 13 Ethernet
+    IntDefaultHandler,                      // 14 Audio I2S
+    IntDefaultHandler,                      // 15 Touch screen
+    IntDefaultHandler,                      // 16 GPIO 2
+    IntDefaultHandler,                      // 17 GPIO 3
+    uart3Isr,                               // 18 UART3 Rx
+    uart3Isr,                               // 19 UART3 Tx
+    uart4Isr,                               // 20 UART4 Rx
+    uart4Isr,                               // 21 UART4 Tx
+    IntDefaultHandler,                      // 22 SPI 2
+    IntDefaultHandler,                      // 23 SPI 3-4
+    IntDefaultHandler,                      // 24 GPIO 0 pin 0
+    IntDefaultHandler,                      // 25 GPIO 0 pin 1
+    IntDefaultHandler,                      // 26 GPIO 0 pin 2
+    IntDefaultHandler,                      // 27 GPIO 0 pin 3
+    IntDefaultHandler,                      // 28 GPIO 0 pin 4
+    IntDefaultHandler,                      // 29 GPIO 0 pin 5
+    IntDefaultHandler,                      // 30 GPIO 0 pin 6
+    IntDefaultHandler                       // 31 GPIO 0 pin 7
+};
+
+//*****************************************************************************
+//
+// Reset: what _c_int00 does for the CCS build. Copies .data out of the image,
+// zeroes .bss, turns on the FPU (CP10 and CP11 full access) and calls main.
+//
+//*****************************************************************************
+void
+ResetISR(void)
+{
+    memcpy(&__data_start__, &__data_load__, (uint32_t)&__data_end__ - (uint32_t)&__data_start__);
+    memset(&__bss_start__, 0, (uint32_t)&__bss_end__ - (uint32_t)&__bss_start__);
+    CPACR_R |= 0xF << 20;
+    __asm volatile ("dsb\n isb");
+    main();
+    while(1)
+    {
+    }
+}
+
+//*****************************************************************************
+//
+// NMI and unexpected interrupts stop here for the debugger (qemu -s -S).
+//
+//*****************************************************************************
+static void
+NmiSR(void)
+{
+    while(1)
+    {
+    }
+}
+
+static void
+IntDefaultHandler(void)
+{
+    while(1)
+    {
+    }
+}
@@ -0,0 +1,129 @@
+// Time Base Library (QEMU port)
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: QEMU mps2-an386
+// Target uC:       Cortex-M4F
+// System Clock:    25 MHz
+
+// Hardware configuration:
+// CMSDK Timer 0 (0x40000000):
+//   32 bit down count of system clocks from 0xFFFFFFFF, its interrupt counts
+//   the wraps in timeBase.wraps for the high word
+// the MPS2 has no wide timer and QEMU models no DWT, so timeCycles() is the
+// low word of the count in either mode. Replaces timebase.c
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "asm.h"
+#include "clock.h"
+#include "timebase.h"
+
+#define TIMER0_CTRL_R       (*((volatile uint32_t *)0x40000000))
+#define TIMER0_VALUE_R      (*((volatile uint32_t *)0x40000004))
+#define TIMER0_RELOAD_R     (*((volatile uint32_t *)0x40000008))
+#define TIMER0_INT_R        (*((volatile uint32_t *)0x4000000C))  // status on read, write 1 to clear
+
+#define CTRL_ENABLE         0x00000001
+#define CTRL_IRQEN          0x00000008
+
+#define IRQ_TIMER0          8
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+volatile TIME_BASE timeBase __attribute__((aligned(TIME_BASE_SIZE)));
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initTimeBase(void)
+{
+    TIMER0_CTRL_R = 0;
+    TIMER0_RELOAD_R = 0xFFFFFFFF;
+    TIMER0_VALUE_R = 0xFFFFFFFF;
+    TIMER0_INT_R = 1;
+
+    timeBase.baseUs = 0;
+    timeBase.baseCount = 0;
+    timeBase.cyclesPerUs = systemClockHz / 1000000;
+    timeBase.wraps = 0;
+    timeBase.seq++;
+    NVIC_EN0_R = 1 << IRQ_TIMER0;
+    TIMER0_CTRL_R = CTRL_ENABLE | CTRL_IRQEN;
+}
+
+void timeBaseIsr(void)
+{
+    TIMER0_INT_R = 1;
+    timeBase.wraps++;
+}
+
+// the clock never changes here, kept for the same API
+void timeRebase(uint32_t fcyc)
+{
+    uint32_t primask = enterCritical();
+    uint64_t count = timeCount();
+    uint64_t elapsed = count - timeBase.baseCount;
+
+    timeBase.baseUs += elapsed / timeBase.cyclesPerUs;
+    timeBase.baseCount = count - elapsed % timeBase.cyclesPerUs;
+    timeBase.cyclesPerUs = fcyc / 1000000;
+    timeBase.seq++;
+    leaveCritical(primask);
+}
+
+// a wrap that is still pending (interrupts masked, or read from a handler
+// that outranks it) is added here, the timer has just reloaded then
+uint64_t timeCount(void)
+{
+    uint32_t wraps, value, pending;
+
+    do
+    {
+        wraps = timeBase.wraps;
+        value = TIMER0_VALUE_R;
+        pending = TIMER0_INT_R & 1;
+    }
+    while (wraps != timeBase.wraps);
+    if (pending && value > 0x80000000)
+        wraps++;
+    return ((uint64_t)wraps << 32) | (uint32_t)~value;
+}
+
+uint64_t timeUs(void)
+{
+    uint32_t seq, perUs;
+    uint64_t baseUs, baseCount, count;
+
+    do
+    {
+        seq = timeBase.seq;
+        perUs = timeBase.cyclesPerUs;
+        baseUs = timeBase.baseUs;
+        baseCount = timeBase.baseCount;
+        count = timeCount();
+    }
+    while (seq != timeBase.seq);
+    return baseUs + (count - baseCount) / perUs;
+}
+
+uint32_t timeCycles(void)
+{
+    return ~TIMER0_VALUE_R;
+}
+
+uint32_t timeCyclesPerUs(void)
+{
+    return timeBase.cyclesPerUs;
+}
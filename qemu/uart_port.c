@@ -0,0 +1,293 @@
+// UART Library (QEMU port)
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: QEMU mps2-an386
+// Target uC:       Cortex-M4F
+// System Clock:    25 MHz
+
+// Hardware configuration:
+// UART Interface:
+//   CMSDK APB UART0-4, UART0 is QEMU's -serial (stdio with -nographic)
+//   UART5-7 do not exist on the MPS2, opening one does nothing
+// same API and buffering as uart.c, which it replaces. CMSDK UARTs have a
+// one byte holding register instead of a FIFO and separate rx/tx interrupts
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "tm4c123gh6pm.h"
+#include "asm.h"
+#include "uart.h"
+#include "trace.h"
+
+// register offsets inside a CMSDK UART block
+#define UART_DATA       0x000
+#define UART_STATUS     0x004
+#define UART_CTRL       0x008
+#define UART_INTSTATUS  0x00C   // write 1 to clear
+#define UART_BAUDDIV    0x010
+
+#define STATUS_TXFULL   0x01
+#define STATUS_RXFULL   0x02
+#define CTRL_TXEN       0x01
+#define CTRL_RXEN       0x02
+#define CTRL_TXINTEN    0x04
+#define CTRL_RXINTEN    0x08
+#define INT_TX          0x01
+#define INT_RX          0x02
+
+#define UART_REG(uart, ofs) (*((volatile uint32_t *)((uart)->base + (ofs))))
+
+#define TX_MASK (UART_TX_SIZE - 1)
+#define RX_MASK (UART_RX_SIZE - 1)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// irq is the rx interrupt, tx is the one after it, the pin fields are unused
+//  base        gpio n  port tx rx pctl irq unlock
+const UART_DESC uarts[8] =
+{
+    {0x40004000, 0, 0, 0, 0, 0, 0,  0, false},  // UART0
+    {0x40005000, 0, 1, 0, 0, 0, 0,  2, false},  // UART1
+    {0x40006000, 0, 2, 0, 0, 0, 0,  4, false},  // UART2
+    {0x40007000, 0, 3, 0, 0, 0, 0, 18, false},  // UART3
+    {0x40009000, 0, 4, 0, 0, 0, 0, 20, false},  // UART4
+    {0,          0, 5, 0, 0, 0, 0,  0, false},
+    {0,          0, 6, 0, 0, 0, 0,  0, false},
+    {0,          0, 7, 0, 0, 0, 0,  0, false}
+};
+
+// NULL until initUart, the driver falls back to polling the holding register
+UART_STATE *uartState[8];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// moves queued bytes into the holding register, tx interrupt stays on while bytes are left
+// caller masks interrupts (or is the uart isr)
+static void uartTxPump(const UART_DESC *uart, UART_STATE *s)
+{
+    while (s->txTail != s->txHead && !(UART_REG(uart, UART_STATUS) & STATUS_TXFULL))
+    {
+        UART_REG(uart, UART_DATA) = s->txBuffer[s->txTail];
+        s->txTail = (s->txTail + 1) & TX_MASK;
+    }
+    if (s->txTail == s->txHead)
+        UART_REG(uart, UART_CTRL) &= ~CTRL_TXINTEN;
+    else
+        UART_REG(uart, UART_CTRL) |= CTRL_TXINTEN;
+}
+
+static void enableIrq(uint8_t irq)
+{
+    (&NVIC_EN0_R)[irq >> 5] = 1 << (irq & 31);
+}
+
+// Initialize UARTn buffers, 115200 baud assuming fcyc = 25 MHz
+void initUart(const UART_DESC *uart, UART_STATE *state)
+{
+    if (uart->base == 0) return;
+
+    UART_REG(uart, UART_CTRL) = 0;
+    UART_REG(uart, UART_BAUDDIV) = 217;                 // 25 MHz / 115200, QEMU wants at least 16
+
+    state->txHead = state->txTail = 0;
+    state->rxHead = state->rxTail = 0;
+    state->rxOverruns = 0;
+    state->rxSeen = false;
+    state->baudRate = 0;
+    uartState[uart->number] = state;
+    UART_REG(uart, UART_INTSTATUS) = INT_TX | INT_RX;
+    enableIrq(uart->irq);
+    enableIrq(uart->irq + 1);
+
+    UART_REG(uart, UART_CTRL) = CTRL_TXEN | CTRL_RXEN | CTRL_RXINTEN;
+}
+
+// Set baud rate as function of instruction cycle frequency
+void setUartBaudRate(const UART_DESC *uart, uint32_t baudRate, uint32_t fcyc)
+{
+    uint32_t divisor = fcyc / baudRate;
+    if (uart->base == 0) return;
+    if (uartState[uart->number] != NULL)
+        uartState[uart->number]->baudRate = baudRate;
+    flushUart(uart);
+    UART_REG(uart, UART_BAUDDIV) = divisor < 16 ? 16 : divisor;
+}
+
+// Queues a character, blocking only while the tx buffer is full
+// works with interrupts masked (fault handlers), the register is then fed by polling
+void putcUart(const UART_DESC *uart, char c)
+{
+    UART_STATE *s = uartState[uart->number];
+
+    if (uart->base == 0) return;
+    if (s == NULL)
+    {
+        while (UART_REG(uart, UART_STATUS) & STATUS_TXFULL);
+        UART_REG(uart, UART_DATA) = c;
+        return;
+    }
+
+    while (true)
+    {
+        uint32_t primask = enterCritical();
+        uint8_t next = (s->txHead + 1) & TX_MASK;
+        if (next != s->txTail)
+        {
+            s->txBuffer[s->txHead] = c;
+            s->txHead = next;
+            uartTxPump(uart, s);
+            leaveCritical(primask);
+            return;
+        }
+        uartTxPump(uart, s);
+        leaveCritical(primask);
+    }
+}
+
+void putsUart(const UART_DESC *uart, const char *str)
+{
+    while (*str != '\0')
+        putcUart(uart, *str++);
+}
+
+void writeUart(const UART_DESC *uart, const uint8_t *data, uint32_t length)
+{
+    while (length--)
+        putcUart(uart, *data++);
+}
+
+char getcUart(const UART_DESC *uart)
+{
+    UART_STATE *s = uartState[uart->number];
+    char c;
+
+    if (s == NULL)
+    {
+        while (!(UART_REG(uart, UART_STATUS) & STATUS_RXFULL));
+        return UART_REG(uart, UART_DATA) & 0xFF;
+    }
+
+    while (s->rxHead == s->rxTail);
+    c = s->rxBuffer[s->rxTail];
+    s->rxTail = (s->rxTail + 1) & RX_MASK;
+    return c;
+}
+
+bool kbhitUart(const UART_DESC *uart)
+{
+    UART_STATE *s = uartState[uart->number];
+
+    if (uart->base == 0) return false;
+    if (s == NULL)
+        return UART_REG(uart, UART_STATUS) & STATUS_RXFULL;
+    return s->rxHead != s->rxTail;
+}
+
+// QEMU hands a written byte to the chardev at once, empty buffer and
+// holding register is as flushed as it gets
+void flushUart(const UART_DESC *uart)
+{
+    UART_STATE *s = uartState[uart->number];
+
+    if (uart->base == 0) return;
+    while (s != NULL && s->txTail != s->txHead)
+    {
+        uint32_t primask = enterCritical();
+        uartTxPump(uart, s);
+        leaveCritical(primask);
+    }
+    while (UART_REG(uart, UART_STATUS) & STATUS_TXFULL);
+}
+
+// sends what is queued, then masks the UART and forgets its state, so the
+// state can be handed to another port
+void closeUart(const UART_DESC *uart)
+{
+    if (uart->base == 0 || uartState[uart->number] == NULL) return;
+    flushUart(uart);
+    (&NVIC_DIS0_R)[uart->irq >> 5] = 1 << (uart->irq & 31);
+    (&NVIC_DIS0_R)[(uart->irq + 1) >> 5] = 1 << ((uart->irq + 1) & 31);
+    UART_REG(uart, UART_CTRL) = 0;
+    uartState[uart->number] = NULL;
+}
+
+// every open UART, before the system clock changes
+void flushUarts(void)
+{
+    uint8_t n;
+    for (n = 0; n < 8; n++)
+        if (uartState[n] != NULL)
+            flushUart(&uarts[n]);
+}
+
+// true when no open UART has a byte queued, a byte waiting or took one since
+// the last call, the model sends at once
+bool uartsIdle(void)
+{
+    uint8_t n;
+    bool idle = true;
+    for (n = 0; n < 8; n++)
+    {
+        if (uartState[n] == NULL) continue;
+        if (uartState[n]->txTail != uartState[n]->txHead || uartState[n]->rxSeen
+         || (UART_REG(&uarts[n], UART_STATUS) & STATUS_RXFULL))
+            idle = false;
+        uartState[n]->rxSeen = false;
+    }
+    return idle;
+}
+
+// after the system clock changed, every open UART gets its baud rate back
+void setUartsClock(uint32_t fcyc)
+{
+    uint8_t n;
+    for (n = 0; n < 8; n++)
+        if (uartState[n] != NULL && uartState[n]->baudRate)
+            setUartBaudRate(&uarts[n], uartState[n]->baudRate, fcyc);
+}
+
+// takes the received byte into the buffer and refills the holding register
+// serves both the rx and the tx interrupt of the UART
+static void uartIsr(const UART_DESC *uart)
+{
+    UART_STATE *s = uartState[uart->number];
+    uint32_t status = UART_REG(uart, UART_INTSTATUS);
+
+    TRACE_POINT(TRACE_ISR_ENTER, uart->irq + 16);
+    UART_REG(uart, UART_INTSTATUS) = status;
+    while (UART_REG(uart, UART_STATUS) & STATUS_RXFULL)
+    {
+        uint8_t c = UART_REG(uart, UART_DATA) & 0xFF;
+        uint8_t next = (s->rxHead + 1) & RX_MASK;
+        if (next != s->rxTail)
+        {
+            s->rxBuffer[s->rxHead] = c;
+            s->rxHead = next;
+        }
+        else
+            s->rxOverruns++;
+        s->rxSeen = true;
+    }
+    if (status & INT_TX)
+        uartTxPump(uart, s);
+    TRACE_POINT(TRACE_ISR_EXIT, uart->irq + 16);
+}
+
+void uart0Isr(void) { uartIsr(&uarts[0]); }
+void uart1Isr(void) { uartIsr(&uarts[1]); }
+void uart2Isr(void) { uartIsr(&uarts[2]); }
+void uart3Isr(void) { uartIsr(&uarts[3]); }
+void uart4Isr(void) { uartIsr(&uarts[4]); }
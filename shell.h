@@ -0,0 +1,51 @@
+// Shell Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef SHELL_H_
+#define SHELL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Info that can be accepted
+#define MAX_CHARS 80
+#define MAX_FIELDS 5
+#define longestCommand 7
+
+// UI info structure
+typedef struct _USER_DATA
+{
+    char buffer[MAX_CHARS+1];
+    uint8_t fieldCount;
+    uint8_t fieldPosition[MAX_FIELDS];
+    char fieldType[MAX_FIELDS];
+    uint32_t* lastMalloc;       // pointer used by the free command
+} USER_DATA;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void getsUart0(USER_DATA *data);
+void parseFields(USER_DATA *data);
+char* getFieldString(USER_DATA* data, uint8_t fieldNumber);
+int32_t getFieldInteger(USER_DATA* data, uint8_t fieldNumber);
+bool sameStr(const char *str1, const char *str2);
+bool isCommand(USER_DATA* data, const char strCommand[], uint8_t minArguments);
+void shell(void);
+
+#endif
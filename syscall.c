@@ -0,0 +1,213 @@
+// System Call Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// System Calls:
+// thin unprivileged wrappers around syscall() (asm.s), these run in the
+// calling task and keep no state of their own
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "asm.h"
+#include "syscall.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void sysYield(void)
+{
+    syscall(SVC_YIELD, 0, 0, 0);
+}
+
+void sysSleep(uint32_t ms)
+{
+    syscall(SVC_SLEEP, ms, 0, 0);
+}
+
+// every task's LR points here, so returning from the task function ends it
+void sysExit(void)
+{
+    syscall(SVC_EXIT, 0, 0, 0);
+    while (true);
+}
+
+void sysPutc(char c)
+{
+    syscall(SVC_PUTC, c, 0, 0);
+}
+
+void sysPuts(const char *str)
+{
+    syscall(SVC_PUTS, (uint32_t)str, 0, 0);
+}
+
+// the kernel blocks the task until a key arrives, then the call is repeated
+char sysGetc(void)
+{
+    int32_t c;
+    while ((c = (int32_t)syscall(SVC_GETC, 0, 0, 0)) < 0);
+    return c;
+}
+
+void *sysMalloc(uint32_t size)
+{
+    return (void *)syscall(SVC_MALLOC, size, 0, 0);
+}
+
+void sysFree(void *p)
+{
+    syscall(SVC_FREE, (uint32_t)p, 0, 0);
+}
+
+void sysDumpHeap(void)
+{
+    syscall(SVC_DUMP_HEAP, 0, 0, 0);
+}
+
+void sysPs(void)
+{
+    syscall(SVC_PS, 0, 0, 0);
+}
+
+void sysIpcs(void)
+{
+    syscall(SVC_IPCS, 0, 0, 0);
+}
+
+bool sysKill(uint32_t pid)
+{
+    return syscall(SVC_KILL, pid, 0, 0);
+}
+
+bool sysPkill(const char *name)
+{
+    return syscall(SVC_PKILL, (uint32_t)name, 0, 0);
+}
+
+uint32_t sysPidof(const char *name)
+{
+    return syscall(SVC_PIDOF, (uint32_t)name, 0, 0);
+}
+
+bool sysRun(const char *name)
+{
+    return syscall(SVC_RUN, (uint32_t)name, 0, 0);
+}
+
+void sysPi(bool on)
+{
+    syscall(SVC_PI, on, 0, 0);
+}
+
+void sysPreempt(bool on)
+{
+    syscall(SVC_PREEMPT, on, 0, 0);
+}
+
+void sysSched(bool prioOn)
+{
+    syscall(SVC_SCHED, prioOn, 0, 0);
+}
+
+void sysReboot(void)
+{
+    syscall(SVC_REBOOT, 0, 0, 0);
+}
+
+uint32_t sysMpuRegion(uint32_t region)
+{
+    return syscall(SVC_MPU_REGION, region, 0, 0);
+}
+
+void sysTlm(uint8_t type)
+{
+    syscall(SVC_TLM, type, 0, 0);
+}
+
+void sysTlmUart(uint8_t n)
+{
+    syscall(SVC_TLM_UART, n, 0, 0);
+}
+
+void sysTrig(TRIG_SETUP setup)
+{
+    syscall(SVC_TRIG, setup, 0, 0);
+}
+
+void sysLogFlush(void)
+{
+    syscall(SVC_LOG_FLUSH, 0, 0, 0);
+}
+
+void sysBench(void)
+{
+    syscall(SVC_BENCH, 0, 0, 0);
+}
+
+void sysCrash(void)
+{
+    syscall(SVC_CRASH, 0, 0, 0);
+}
+
+void sysFaults(void)
+{
+    syscall(SVC_FAULTS, 0, 0, 0);
+}
+
+uint32_t sysClock(uint8_t profile)
+{
+    return syscall(SVC_CLOCK, profile, 0, 0);
+}
+
+uint32_t sysGovernor(uint8_t mode)
+{
+    return syscall(SVC_GOVERNOR, mode, 0, 0);
+}
+
+void sysProfile(uint32_t hz)
+{
+    syscall(SVC_PROFILE, hz, 0, 0);
+}
+
+void sysTrace(uint8_t mode)
+{
+    syscall(SVC_TRACE, mode, 0, 0);
+}
+
+uint32_t sysLatency(uint32_t samples)
+{
+    return syscall(SVC_LATENCY, samples, 0, 0);
+}
+
+// returns once the latency timer woke the caller
+void sysLatencyWait(uint32_t cycles)
+{
+    syscall(SVC_LATENCY_WAIT, cycles, 0, 0);
+}
+
+// returns while a latency run lasts, sleeps in the kernel between runs
+void sysLoadWait(void)
+{
+    syscall(SVC_LOAD_WAIT, 0, 0, 0);
+}
+
+// next button event (button.h), sleeps until there is one
+uint8_t sysButton(void)
+{
+    int32_t event;
+    while ((event = (int32_t)syscall(SVC_BUTTON, 0, 0, 0)) < 0);
+    return event;
+}
@@ -0,0 +1,123 @@
+// System Call Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef SYSCALL_H_
+#define SYSCALL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               SYSCALL CONVENTION
+ * ==========================================================================
+ *  syscall(number, a, b, c) -> SVC #0 -> svcISR -> svcCall(frame)
+ *  frame[0] = number on entry and the result on return, frame[1-3] = a, b, c
+ *
+ *  the sys* wrappers below are the only way an unprivileged task reaches the
+ *  kernel, OS RAM and the PPB (MPU, NVIC, SysTick) are closed to it
+ */
+
+// append only, the numbers are the ABI between tasks and the kernel
+typedef enum _SVC_NUMBER
+{
+    SVC_YIELD,
+    SVC_SLEEP,              // a = ms
+    SVC_EXIT,
+    SVC_PUTC,               // a = character
+    SVC_PUTS,               // a = string in flash or the caller's own blocks
+    SVC_GETC,               // returns -1 and blocks the caller when nothing was typed
+    SVC_MALLOC,             // a = bytes, counts against the heap quota
+    SVC_FREE,               // a = pointer
+    SVC_DUMP_HEAP,
+    SVC_PS,
+    SVC_IPCS,
+    SVC_KILL,               // a = pid
+    SVC_PKILL,              // a = name
+    SVC_PIDOF,              // a = name
+    SVC_RUN,                // a = name
+    SVC_PI,                 // a = on
+    SVC_PREEMPT,            // a = on
+    SVC_SCHED,              // a = priority scheduling on
+    SVC_REBOOT,
+    SVC_MPU_REGION,         // a = region, returns MPU_ATTR
+    SVC_TLM,                // a = TLM_TYPE
+    SVC_TLM_UART,           // a = UART number
+    SVC_TRIG,               // a = TRIG_SETUP
+    SVC_LOG_FLUSH,
+    SVC_BENCH,
+    SVC_CRASH,
+    SVC_FAULTS,
+    SVC_BUTTON,             // returns -1 and blocks the caller when no event is queued
+    SVC_CLOCK,              // a = CLOCK_PROFILE or CLOCK_PROFILES to keep it, returns Hz, stops the governor
+    SVC_GOVERNOR,           // a = 0 off, 1 on, else keep, returns on << 8 | idle %
+    SVC_PROFILE,            // a = rate in Hz to start, 0 to stop, PROFILE_STATUS to only print
+    SVC_TRACE,              // a = 0 stop, 1 start, else only print
+    SVC_LATENCY,            // a = samples to start, 0 to stop, LATENCY_QUERY or LATENCY_REPORT, returns samples left
+    SVC_LATENCY_WAIT,       // a = cycles from the timeout to the caller's last wake, blocks until the next timeout
+    SVC_LOAD_WAIT           // blocks until a latency run starts, returns at once during one
+} SVC_NUMBER;
+
+// privileged half of the trig command, the task then faults by itself
+typedef enum _TRIG_SETUP
+{
+    TRIG_USAGE,             // trap divide by zero
+    TRIG_HARD,              // trap divide by zero with the usage fault handler off
+    TRIG_PENDSV             // pend a PendSV and log it
+} TRIG_SETUP;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void sysYield(void);
+void sysSleep(uint32_t ms);
+void sysExit(void);
+void sysPutc(char c);
+void sysPuts(const char *str);
+char sysGetc(void);
+void *sysMalloc(uint32_t size);
+void sysFree(void *p);
+void sysDumpHeap(void);
+void sysPs(void);
+void sysIpcs(void);
+bool sysKill(uint32_t pid);
+bool sysPkill(const char *name);
+uint32_t sysPidof(const char *name);
+bool sysRun(const char *name);
+void sysPi(bool on);
+void sysPreempt(bool on);
+void sysSched(bool prioOn);
+void sysReboot(void);
+uint32_t sysMpuRegion(uint32_t region);
+void sysTlm(uint8_t type);
+void sysTlmUart(uint8_t n);
+void sysTrig(TRIG_SETUP setup);
+void sysLogFlush(void);
+void sysBench(void);
+void sysCrash(void);
+void sysFaults(void);
+uint8_t sysButton(void);
+uint32_t sysClock(uint8_t profile);
+uint32_t sysGovernor(uint8_t mode);
+void sysProfile(uint32_t hz);
+void sysTrace(uint8_t mode);
+uint32_t sysLatency(uint32_t samples);
+void sysLatencyWait(uint32_t cycles);
+void sysLoadWait(void);
+
+#endif
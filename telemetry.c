@@ -0,0 +1,305 @@
+// Telemetry Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// UART Interface:
+//   frames share UART0 with the shell unless tlmUseUart picks another port
+//   (UART1 on PB1/PB0 is free on the EK-TM4C123GXL)
+// Telemetry:
+// typed binary records (heap, MPU, tasks, log) in COBS frames with a CRC,
+// decoded on the PC by tools/telemetry.py. A heap snapshot is 89 bytes
+// instead of the ~1 KB dumpHeap table
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "tm4c123gh6pm.h"
+#include "asm.h"
+#include "telemetry.h"
+#include "uart.h"
+#include "mem.h"
+#include "kernel.h"
+#include "crash.h"
+#include "profile.h"
+#include "timebase.h"
+#include "trace.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+extern uint64_t srdBitmask;
+uint8_t tlmSequence = 0;
+
+// UART0 shares the shell console, tlmUseUart moves the frames to a faster port
+const UART_DESC *tlmUart = &uarts[0];
+UART_STATE tlmUartState;
+
+// CRC-16/CCITT one nibble at a time, 16 entry table instead of 256
+static const uint16_t crcNibble[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint16_t crc16(const uint8_t *data, uint32_t length, uint16_t crc)
+{
+    while (length--)
+    {
+        crc = (crc << 4) ^ crcNibble[(crc >> 12) ^ (*data >> 4)];
+        crc = (crc << 4) ^ crcNibble[(crc >> 12) ^ (*data & 0x0F)];
+        data++;
+    }
+    return crc;
+}
+
+// replaces every zero byte with the distance to the next one, returns encoded length
+static uint32_t cobsEncode(const uint8_t *in, uint32_t length, uint8_t *out)
+{
+    uint32_t codeIndex = 0;
+    uint32_t o = 1;
+    uint8_t code = 1;
+    uint32_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        if (in[i] == 0)
+        {
+            out[codeIndex] = code;
+            codeIndex = o++;
+            code = 1;
+        }
+        else
+        {
+            out[o++] = in[i];
+            code++;
+            if (code == 0xFF)
+            {
+                out[codeIndex] = code;
+                codeIndex = o++;
+                code = 1;
+            }
+        }
+    }
+    out[codeIndex] = code;
+    return o;
+}
+
+static void putLe16(uint8_t *p, uint16_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static void putLe32(uint8_t *p, uint32_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = value >> 24;
+}
+
+// frames live on the caller's stack so a fault handler can send while the shell is mid-frame
+void tlmSendFrame(TLM_TYPE type, const uint8_t *payload, uint32_t length)
+{
+    uint8_t raw[TLM_MAX_PAYLOAD + 4];
+    uint8_t encoded[TLM_MAX_PAYLOAD + 6];
+
+    if (length > TLM_MAX_PAYLOAD) return;
+
+    raw[0] = type;
+    raw[1] = tlmSequence++;
+    memcpy(&raw[2], payload, length);
+    uint16_t crc = crc16(raw, length + 2, 0xFFFF);
+    putLe16(&raw[length + 2], crc);
+
+    uint32_t n = cobsEncode(raw, length + 4, encoded);
+    putcUart(tlmUart, 0);
+    writeUart(tlmUart, encoded, n);
+    putcUart(tlmUart, 0);
+}
+
+// sends frames to UARTn from now on, UART0 goes back to the shell console.
+// The port used before is closed first, only one at a time has tlmUartState
+void tlmUseUart(uint8_t n, uint32_t baudRate, uint32_t fcyc)
+{
+    if (n > 7) return;
+    if (tlmUart != &uarts[0])
+        closeUart(tlmUart);
+    if (n != 0)
+    {
+        initUart(&uarts[n], &tlmUartState);
+        setUartBaudRate(&uarts[n], baudRate, fcyc);
+    }
+    tlmUart = &uarts[n];
+}
+
+// blockArray and the SRD mask, 3 bytes per block
+void tlmSendHeap(void)
+{
+    uint8_t payload[1 + 4 + NUM_BLOCKS * 3];
+    uint8_t *p = payload;
+    int i;
+
+    *p++ = NUM_BLOCKS;
+    putLe32(p, (uint32_t)srdBitmask); p += 4;
+    for (i = 0; i < NUM_BLOCKS; i++)
+    {
+        *p++ = (blockArray[i].alloc ? 0x80 : 0) | (blockArray[i].size & 0x7F);
+        putLe16(p, blockArray[i].owner); p += 2;
+    }
+    tlmSendFrame(TLM_HEAP, payload, p - payload);
+}
+
+// raw MPU_BASE/MPU_ATTR of all 8 regions, decoded on the PC
+void tlmSendMpu(void)
+{
+    uint8_t payload[4 + 8 * 8];
+    uint8_t *p = payload;
+    uint32_t region;
+
+    putLe32(p, NVIC_MPU_CTRL_R); p += 4;
+    for (region = 0; region < 8; region++)
+    {
+        NVIC_MPU_NUMBER_R = region;
+        putLe32(p, NVIC_MPU_BASE_R); p += 4;
+        putLe32(p, NVIC_MPU_ATTR_R); p += 4;
+    }
+    tlmSendFrame(TLM_MPU, payload, p - payload);
+}
+
+// every task slot in use, tasks all run unprivileged
+void tlmSendTasks(void)
+{
+    uint8_t payload[1 + MAX_TASKS * 12];
+    uint8_t *p = payload + 1;
+    uint8_t i;
+
+    payload[0] = 0;
+    for (i = 0; i < MAX_TASKS; i++)
+    {
+        if (tcb[i].state == STATE_INVALID) continue;
+        putLe16(p, tcb[i].pid); p += 2;
+        *p++ = tcb[i].state;
+        *p++ = 0;                           // privileged
+        putLe32(p, (uint32_t)(i == taskCurrent ? getPsp() : tcb[i].sp)); p += 4;
+        putLe16(p, tcb[i].stackSize); p += 2;
+        putLe16(p, tcb[i].state == STATE_DEAD ? 0 : stackPeak(i)); p += 2;
+        payload[0]++;
+    }
+    tlmSendFrame(TLM_TASKS, payload, p - payload);
+}
+
+// the fault counters of crash.h, pids in use only
+void tlmSendFaults(void)
+{
+    uint8_t payload[COUNT_TYPES * 4 + 1 + FAULT_PIDS * (2 + COUNT_TYPES * 2)];
+    uint8_t *p = payload;
+    uint8_t *count;
+    uint8_t i, t;
+
+    for (t = 0; t < COUNT_TYPES; t++)
+    {
+        putLe32(p, faultCounters.count[t]); p += 4;
+    }
+    count = p++;
+    *count = 0;
+    for (i = 0; i < FAULT_PIDS; i++)
+    {
+        if (faultCounters.pids[i].pid == FAULT_NO_PID) continue;
+        putLe16(p, faultCounters.pids[i].pid); p += 2;
+        for (t = 0; t < COUNT_TYPES; t++)
+        {
+            putLe16(p, faultCounters.pids[i].count[t]); p += 2;
+        }
+        (*count)++;
+    }
+    tlmSendFrame(TLM_FAULTS, payload, p - payload);
+}
+
+// the profiler histogram, 13 used slots per frame
+void tlmSendProfile(void)
+{
+    uint8_t payload[TLM_MAX_PAYLOAD];
+    uint8_t *p = payload + 12;
+    uint8_t sent = 0, count = 0;
+    uint32_t i;
+
+    for (i = 0; i <= PROFILE_SLOTS; i++)
+    {
+        bool last = i == PROFILE_SLOTS || profileTable == NULL;
+        if (!last && profileTable[i].pc == 0) continue;
+        if (!last)
+        {
+            putLe32(p, profileTable[i].pc); p += 4;
+            putLe16(p, profileTable[i].pid); p += 2;
+            putLe16(p, profileTable[i].count); p += 2;
+            count++;
+        }
+        if (last || p + 8 > payload + TLM_MAX_PAYLOAD)
+        {
+            putLe32(payload, profileSamples);
+            putLe32(payload + 4, profileDropped);
+            putLe16(payload + 8, profileRate);
+            payload[10] = sent;
+            payload[11] = count;
+            tlmSendFrame(TLM_PROFILE, payload, p - payload);
+            sent += count;
+            count = 0;
+            p = payload + 12;
+        }
+        if (last) break;
+    }
+}
+
+// the trace ring, oldest event first, 14 events per frame. Stops the trace so
+// the ring holds still while it goes out
+void tlmSendTrace(void)
+{
+    uint8_t payload[TLM_MAX_PAYLOAD];
+    uint8_t *p = payload + 8;
+    uint32_t kept, i;
+    uint16_t sent = 0;
+    uint8_t count = 0;
+
+    traceStop();
+    kept = traceRing == NULL ? 0 : (traceHead < TRACE_EVENTS ? traceHead : TRACE_EVENTS);
+    for (i = 0; i <= kept; i++)
+    {
+        bool last = i == kept;
+        if (!last)
+        {
+            TRACE_RECORD *r = &traceRing[(traceHead - kept + i) & (TRACE_EVENTS - 1)];
+            putLe32(p, r->cycles); p += 4;
+            putLe32(p, r->word); p += 4;
+            count++;
+        }
+        if (last || p + 8 > payload + TLM_MAX_PAYLOAD)
+        {
+            putLe32(payload, traceHead);
+            payload[4] = timeCyclesPerUs();
+            payload[5] = count;
+            putLe16(payload + 6, sent);
+            tlmSendFrame(TLM_TRACE, payload, p - payload);
+            sent += count;
+            count = 0;
+            p = payload + 8;
+        }
+    }
+}
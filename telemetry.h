@@ -0,0 +1,84 @@
+// Telemetry Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// UART Interface:
+//   frames share UART0 with the shell unless tlmUseUart picks another port
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               TELEMETRY FRAME
+ * ==========================================================================
+ *  0x00 | COBS( type | seq | payload ... | crc16 lo | crc16 hi ) | 0x00
+ *
+ *  crc16 is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over type, seq and
+ *  payload. The shell never sends 0x00, so everything between two zero bytes
+ *  is a frame and everything else is console text (tools/telemetry.py)
+ *
+ * ==========================================================================
+ *               RECORD PAYLOADS (little endian)
+ * ==========================================================================
+ *  TLM_LOG    seq(1) id(1) argc(1) args(4 x argc)           see log.h
+ *  TLM_HEAP   blocks(1) srd(4) then per block:
+ *             flags(1) [7] alloc [6:0] size in blocks, owner(2)
+ *  TLM_MPU    ctrl(4) then per region 0-7: base(4) attr(4)
+ *  TLM_TASKS  count(1) then per task:
+ *             pid(2) state(1) priv(1) sp(4) stack(2) peak(2)
+ *  TLM_FAULTS bus(4) usage(4) hard(4) mpu(4) pendsv(4) count(1) then per pid:
+ *             pid(2) bus(2) usage(2) hard(2) mpu(2) pendsv(2)
+ *  TLM_PROFILE samples(4) dropped(4) hz(2) first(1) count(1) then per pc:
+ *             pc(4) pid(2) count(2), one dump is as many frames as it
+ *             takes, first counts the entries sent before (profile.h)
+ *  TLM_TRACE  events(4) rate(1) count(1) first(2) then per event, oldest first:
+ *             count(4) word(4), as many frames as it takes (trace.h).
+ *             rate is the time base counts per us when the dump was taken,
+ *             TRACE_CLOCK events tell the rate before them
+ */
+
+#define TLM_MAX_PAYLOAD 120
+#define TLM_FAST_BAUD   921600
+
+typedef enum _TLM_TYPE
+{
+    TLM_LOG   = 1,
+    TLM_HEAP  = 2,
+    TLM_MPU   = 3,
+    TLM_TASKS = 4,
+    TLM_FAULTS = 5,
+    TLM_PROFILE = 6,
+    TLM_TRACE = 7
+} TLM_TYPE;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint16_t crc16(const uint8_t *data, uint32_t length, uint16_t crc);
+void tlmUseUart(uint8_t n, uint32_t baudRate, uint32_t fcyc);
+void tlmSendFrame(TLM_TYPE type, const uint8_t *payload, uint32_t length);
+void tlmSendHeap(void);
+void tlmSendMpu(void);
+void tlmSendTasks(void);
+void tlmSendFaults(void);
+void tlmSendProfile(void);
+void tlmSendTrace(void);
+
+#endif
@@ -0,0 +1,120 @@
+// Time Base Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Wide Timer 0:
+//   A and B concatenated, 64 bit periodic up count of system clocks
+// DWT:
+//   CYCCNT, enabled by initTimeBase
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "asm.h"
+#include "bench.h"
+#include "clock.h"
+#include "timebase.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+volatile TIME_BASE timeBase __attribute__((aligned(TIME_BASE_SIZE)));
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// before the first setSystemClock, the count starts at the reset clock
+void initTimeBase(void)
+{
+    SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R0;
+    _delay_cycles(3);
+    WTIMER0_CTL_R &= ~TIMER_CTL_TAEN;
+    WTIMER0_CFG_R = 0;                  // A and B as one 64 bit timer
+    WTIMER0_TAMR_R = TIMER_TAMR_TAMR_PERIOD | TIMER_TAMR_TACDIR;
+    WTIMER0_TAILR_R = 0xFFFFFFFF;
+    WTIMER0_TBILR_R = 0xFFFFFFFF;       // counts up from 0
+
+    timeBase.baseUs = 0;
+    timeBase.baseCount = 0;
+    timeBase.cyclesPerUs = systemClockHz / 1000000;
+    timeBase.wraps = 0;
+    timeBase.seq++;
+    WTIMER0_CTL_R |= TIMER_CTL_TAEN;
+
+    initCycleCounter();
+}
+
+// the counter runs at fcyc from now on, the counts so far become microseconds
+// at the old rate. The remainder is kept so no fraction is lost on the way
+void timeRebase(uint32_t fcyc)
+{
+    uint32_t primask = enterCritical();  // no handler ever sees half of it
+    uint64_t count = timeCount();
+    uint64_t elapsed = count - timeBase.baseCount;
+
+    timeBase.baseUs += elapsed / timeBase.cyclesPerUs;
+    timeBase.baseCount = count - elapsed % timeBase.cyclesPerUs;
+    timeBase.cyclesPerUs = fcyc / 1000000;
+    timeBase.seq++;
+    leaveCritical(primask);
+}
+
+// system clocks since boot, the high word is read again in case the low one
+// carried into it in between
+uint64_t timeCount(void)
+{
+    uint32_t high, low;
+
+    do
+    {
+        high = WTIMER0_TBV_R;
+        low = WTIMER0_TAV_R;
+    }
+    while (high != WTIMER0_TBV_R);
+    return ((uint64_t)high << 32) | low;
+}
+
+// microseconds since boot, monotonic across clock changes
+uint64_t timeUs(void)
+{
+    uint32_t seq, perUs;
+    uint64_t baseUs, baseCount, count;
+
+    do
+    {
+        seq = timeBase.seq;
+        perUs = timeBase.cyclesPerUs;
+        baseUs = timeBase.baseUs;
+        baseCount = timeBase.baseCount;
+        count = timeCount();
+    }
+    while (seq != timeBase.seq);
+    return baseUs + (count - baseCount) / perUs;
+}
+
+// core clocks, for deltas taken in one mode (see timebase.h)
+uint32_t timeCycles(void)
+{
+    if (getIpsr() != 0 || !(getControl() & 1))
+        return DWT_CYCCNT_R;
+    return WTIMER0_TAV_R;
+}
+
+uint32_t timeCyclesPerUs(void)
+{
+    return timeBase.cyclesPerUs;
+}
@@ -0,0 +1,74 @@
+// Time Base Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Wide Timer 0:
+//   A and B concatenated, 64 bit periodic up count of system clocks
+// DWT:
+//   CYCCNT, cycle stamps in privileged code
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               TIME BASE
+ * ==========================================================================
+ *  count:   Wide Timer 0 counts system clocks from boot and never wraps
+ *           (7000+ years at 80 MHz). Its registers are peripherals, tasks
+ *           read them directly
+ *  rebase:  the count rate follows the clock profile, so each clock change
+ *           folds the counts so far into baseUs at the old rate and starts
+ *           over at the new one (clock.c calls timeRebase)
+ *  share:   timeBase sits in OS RAM, MPU region 7 makes its 32 bytes read
+ *           only for tasks. timeUs() is a plain function call from either
+ *           mode, no SVC. seq changes with every rebase and a reader that
+ *           was preempted by one reads again
+ *
+ *  timeCycles() is for short deltas: CYCCNT from privileged code, the low
+ *  word of the count from a task (the PPB is privileged only). Both count
+ *  core clocks, take both stamps of a delta in the same mode. CYCCNT stops
+ *  while the core sleeps in WFI, the count does not
+ */
+
+typedef struct _TIME_BASE
+{
+    uint32_t seq;                       // changes with every rebase
+    uint32_t cyclesPerUs;               // count rate since baseCount
+    uint64_t baseUs;                    // time at baseCount
+    uint64_t baseCount;
+    uint32_t wraps;                     // ports with a narrower counter keep the high word here
+    uint32_t spare;
+} TIME_BASE;
+
+#define TIME_BASE_SIZE  32              // MPU region, power of 2 and aligned to it
+
+extern volatile TIME_BASE timeBase;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initTimeBase(void);
+void timeRebase(uint32_t fcyc);
+uint64_t timeCount(void);
+uint64_t timeUs(void);
+uint32_t timeCycles(void);
+uint32_t timeCyclesPerUs(void);
+
+#endif
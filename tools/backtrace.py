@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# Backtrace symbolizer
+# Angelina Abuhilal
+#
+# Maps the addresses of a "Backtrace:" line (crash command, MPU kill report)
+# to function+offset using the symbol table of the ELF image (CCS .out or the
+# QEMU rtos.elf). With --addr2line the source line is added as well.
+#
+#   python3 tools/backtrace.py Debug/rtos.out capture.txt
+#   python3 tools/backtrace.py qemu/rtos.elf - < console.txt
+#   python3 tools/backtrace.py Debug/rtos.out --addr 0x1A3F 0x2211
+
+import argparse
+import bisect
+import re
+import shutil
+import struct
+import subprocess
+import sys
+
+STT_FUNC = 2
+BACKTRACE = re.compile(r'Backtrace:((?:\s+0x[0-9A-Fa-f]+)*)')
+
+
+def load_functions(path):
+    """Sorted (start, size, name) of every function symbol, Thumb bit cleared."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+        raise ValueError('%s is not a 32 bit little endian ELF file' % path)
+
+    shoff, = struct.unpack_from('<I', data, 0x20)
+    shentsize, shnum = struct.unpack_from('<HH', data, 0x2E)
+    sections = [struct.unpack_from('<IIIIIIIIII', data, shoff + i * shentsize) for i in range(shnum)]
+
+    functions = []
+    for _, stype, _, _, offset, size, link, _, _, entsize in sections:
+        if stype != 2:                      # SHT_SYMTAB
+            continue
+        strtab = sections[link]
+        for k in range(size // entsize):
+            name, value, symsize, info, _, _ = struct.unpack_from('<IIIBBH', data, offset + k * entsize)
+            if info & 0xF != STT_FUNC:
+                continue
+            start = strtab[4] + name
+            functions.append((value & ~1, symsize, data[start:data.index(b'\0', start)].decode()))
+    functions.sort()
+    return functions
+
+
+def lookup(functions, address):
+    k = bisect.bisect_right(functions, (address, 0xFFFFFFFF, '')) - 1
+    if k < 0:
+        return '??'
+    start, size, name = functions[k]
+    if size and address >= start + size:
+        return '??'
+    return '%s+0x%x' % (name, address - start)
+
+
+def source_lines(elf, addresses):
+    tool = shutil.which('arm-none-eabi-addr2line') or shutil.which('addr2line')
+    if not tool or not addresses:
+        return [''] * len(addresses)
+    out = subprocess.run([tool, '-e', elf] + ['0x%x' % a for a in addresses],
+                         capture_output=True, text=True).stdout.split('\n')
+    return [line if not line.startswith('??') else '' for line in out[:len(addresses)]]
+
+
+def symbolize(functions, elf, values, with_lines):
+    # the first entry is the faulting pc, the rest return to the instruction after a call
+    addresses = [(v & ~1) - (2 if i else 0) for i, v in enumerate(values)]
+    lines = source_lines(elf, addresses) if with_lines else [''] * len(addresses)
+    for i, (value, address, line) in enumerate(zip(values, addresses, lines)):
+        print('  #%d 0x%08x %s %s' % (i, value, lookup(functions, address), line))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Symbolize fault backtraces against the ELF image')
+    parser.add_argument('elf', help='image the board was running')
+    parser.add_argument('input', nargs='?', default='-', help='console text with Backtrace: lines, - for stdin')
+    parser.add_argument('--addr', nargs='+', help='symbolize these addresses instead')
+    parser.add_argument('--addr2line', action='store_true', help='add file:line from addr2line')
+    args = parser.parse_args()
+
+    functions = load_functions(args.elf)
+    if args.addr:
+        symbolize(functions, args.elf, [int(a, 0) for a in args.addr], args.addr2line)
+        return
+
+    stream = sys.stdin if args.input == '-' else open(args.input, errors='replace')
+    for text in stream:
+        match = BACKTRACE.search(text)
+        if not match:
+            continue
+        print(text.rstrip())
+        symbolize(functions, args.elf, [int(v, 16) for v in match.group(1).split()], args.addr2line)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+# Deferred log format table
+# Angelina Abuhilal
+#
+# Rebuilds the log string table from logfmt.h and formats TLM_LOG records
+# (log.c). tools/telemetry.py uses this to print log records; run on its own
+# it lists the table, which is handy when adding new messages.
+#
+#   python3 tools/logdecode.py [--formats logfmt.h]
+
+import argparse
+import os
+import re
+
+DEFAULT_FORMATS = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'logfmt.h')
+
+
+def load_formats(path=DEFAULT_FORMATS):
+    """Builds the id -> (name, format) table, ids are line positions in LOG_FORMATS."""
+    table = []
+    pattern = re.compile(r'^\s*X\(\s*(LOG_\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+    with open(path) as f:
+        for line in f:
+            m = pattern.search(line)
+            if m:
+                table.append((m.group(1), m.group(2)))
+    return table
+
+
+def format_record(table, rid, args):
+    if rid >= len(table):
+        return 'unknown log id %d %s' % (rid, ' '.join('0x%08X' % a for a in args))
+    name, fmt = table[rid]
+    values = []
+    for i, spec in enumerate(re.findall(r'%[udx]', fmt)):
+        value = args[i] if i < len(args) else 0
+        # %d arguments arrive as raw 32-bit words
+        if spec == '%d' and value & 0x80000000:
+            value -= 1 << 32
+        values.append(value)
+    return fmt.replace('%x', '0x%08X').replace('%u', '%d') % tuple(values)
+
+
+def decode_log_payload(table, payload):
+    """TLM_LOG payload: seq(1) id(1) argc(1) args(4 x argc)."""
+    seq, rid, argc = payload[0], payload[1], payload[2]
+    args = [int.from_bytes(payload[3 + 4 * i:7 + 4 * i], 'little') for i in range(argc)]
+    return seq, format_record(table, rid, args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='List the deferred log format table')
+    parser.add_argument('--formats', default=DEFAULT_FORMATS, help='path to logfmt.h')
+    args = parser.parse_args()
+    for rid, (name, fmt) in enumerate(load_formats(args.formats)):
+        print('%3d  %-24s %s' % (rid, name, fmt))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+# Profile report
+# Angelina Abuhilal
+#
+# Collects the TLM_PROFILE frames of "tlm profile" from the UART stream
+# (serial port, capture file or stdin) and adds the sampled pcs up per
+# function using the symbol table of the ELF image the board was running.
+# The last complete dump in the stream is reported.
+#
+#   python3 tools/pcprofile.py Debug/rtos.out /dev/ttyACM0
+#   python3 tools/pcprofile.py qemu/rtos.elf capture.bin --pid --top 20
+#   python3 tools/pcprofile.py Debug/rtos.out capture.bin --pcs
+
+import argparse
+import bisect
+import collections
+import sys
+
+import backtrace
+import telemetry
+
+
+def read_dumps(stream):
+    """Every complete dump: (samples, dropped, hz, [(pc, pid, count)])."""
+    dumps, current, frame = [], None, None
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        for byte in chunk:
+            if byte != 0:
+                if frame is not None:
+                    frame.append(byte)
+                continue
+            if frame:
+                try:
+                    rtype, _, payload = telemetry.decode_frame(bytes(frame))
+                except ValueError:
+                    rtype = None
+                if rtype == telemetry.TLM_PROFILE:
+                    samples, dropped, hz, first, slots = telemetry.parse_profile(payload)
+                    if first == 0:
+                        current = (samples, dropped, hz, [])
+                    if current is not None:
+                        current[3].extend(slots)
+                        if len(slots) < 13:         # a short frame ends the dump
+                            dumps.append(current)
+                            current = None
+            frame = bytearray()
+    return dumps
+
+
+def function_of(functions, starts, pc):
+    k = bisect.bisect_right(starts, pc & ~1) - 1
+    if k < 0:
+        return '??'
+    start, size, name = functions[k]
+    if size and (pc & ~1) >= start + size:
+        return '??'
+    return name
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Per function report of a tlm profile dump')
+    parser.add_argument('elf', help='image the board was running')
+    parser.add_argument('input', help='serial device, capture file or - for stdin')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--pid', action='store_true', help='one line per function and pid')
+    parser.add_argument('--pcs', action='store_true', help='one line per sampled pc instead')
+    parser.add_argument('--top', type=int, default=0, help='only the N busiest lines')
+    args = parser.parse_args()
+
+    dumps = read_dumps(telemetry.open_stream(args.input, args.baud))
+    if not dumps:
+        sys.exit('no complete profile dump in %s, run "tlm profile" on the target' % args.input)
+    samples, dropped, hz, slots = dumps[-1]
+
+    functions = backtrace.load_functions(args.elf)
+    starts = [f[0] for f in functions]
+    totals = collections.Counter()
+    for pc, pid, count in slots:
+        if args.pcs:
+            key = ('0x%08x' % pc, backtrace.lookup(functions, pc & ~1))
+        else:
+            key = (function_of(functions, starts, pc),)
+        if args.pid:
+            key += ('pid %d' % pid,)
+        totals[key] += count
+
+    counted = sum(totals.values())
+    print('%d samples at %d Hz (%.2f s), %d dropped, %d not in the dump (count saturated)'
+          % (samples, hz, samples / hz if hz else 0, dropped, max(samples - dropped - counted, 0)))
+    print('  SAMPLES      %  WHERE')
+    for key, count in totals.most_common(args.top or None):
+        print('  %7d %5.1f%%  %s' % (count, 100.0 * count / counted if counted else 0, '  '.join(key)))
+
+
+if __name__ == '__main__':
+    main()
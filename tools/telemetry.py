@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+# Telemetry reader
+# Angelina Abuhilal
+#
+# Splits the UART byte stream (serial port, capture file or stdin) into
+# console text and COBS/CRC telemetry frames (telemetry.h) and prints the
+# decoded records next to the shell output.
+#
+#   python3 tools/telemetry.py /dev/ttyACM0
+#   python3 tools/telemetry.py capture.bin --raw
+
+import argparse
+import os
+import struct
+import sys
+
+import logdecode
+
+TLM_LOG, TLM_HEAP, TLM_MPU, TLM_TASKS, TLM_FAULTS, TLM_PROFILE, TLM_TRACE = 1, 2, 3, 4, 5, 6, 7
+
+HEAP_START = 0x20001000
+BLOCK_SIZE = 1024
+TASK_STATES = {0: 'invalid', 1: 'running', 2: 'ready', 3: 'blocked', 4: 'dead'}
+MPU_AP = {0: '--/--', 1: 'RW/--', 2: 'RW/R-', 3: 'RW/RW', 5: 'R-/--', 6: 'R-/R-', 7: 'R-/R-'}
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, same as crc16() in telemetry.c."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError('bad COBS code')
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_frame(encoded):
+    """Returns (type, seq, payload) or raises ValueError."""
+    raw = cobs_decode(encoded)
+    if len(raw) < 4:
+        raise ValueError('short frame')
+    body, crc = raw[:-2], int.from_bytes(raw[-2:], 'little')
+    if crc16(body) != crc:
+        raise ValueError('crc mismatch')
+    return body[0], body[1], body[2:]
+
+
+def format_heap(payload):
+    blocks = payload[0]
+    srd = struct.unpack_from('<I', payload, 1)[0]
+    lines = ['heap snapshot, srd 0x%08X' % srd, ' BLOCK |  ADDRESS   | ALLOC | SIZE | OWNER']
+    for i in range(blocks):
+        flags, owner = struct.unpack_from('<BH', payload, 5 + 3 * i)
+        lines.append(' %5d | 0x%08X |   %d   | %4d | %5d'
+                     % (i, HEAP_START + BLOCK_SIZE * i, flags >> 7, flags & 0x7F, owner))
+    return '\n'.join(lines)
+
+
+def format_mpu(payload):
+    ctrl = struct.unpack_from('<I', payload, 0)[0]
+    lines = ['mpu ctrl 0x%08X (%s)' % (ctrl, 'enabled' if ctrl & 1 else 'disabled'),
+             ' REGION |    BASE    |  SIZE  | PRIV/UNPRIV | XN | SRD  | EN']
+    for region in range(8):
+        base, attr = struct.unpack_from('<II', payload, 4 + 8 * region)
+        size = 1 << (((attr >> 1) & 0x1F) + 1)
+        lines.append(' %6d | 0x%08X | %6s |    %s    | %d  | 0x%02X | %d'
+                     % (region, base & ~0x1F, human_size(size), MPU_AP.get((attr >> 24) & 7, '?'),
+                        (attr >> 28) & 1, (attr >> 8) & 0xFF, attr & 1))
+    return '\n'.join(lines)
+
+
+def format_tasks(payload):
+    lines = [' PID | STATE   | PRIV |     SP     | STACK | PEAK']
+    for i in range(payload[0]):
+        pid, state, priv, sp, stack, peak = struct.unpack_from('<HBBIHH', payload, 1 + 12 * i)
+        lines.append(' %3d | %-7s |  %d   | 0x%08X | %5d | %4d'
+                     % (pid, TASK_STATES.get(state, state), priv, sp, stack, peak))
+    return '\n'.join(lines)
+
+
+def format_faults(payload):
+    totals = struct.unpack_from('<5I', payload, 0)
+    lines = [' PID  |    BUS |  USAGE |   HARD |    MPU |     PENDSV',
+             ' all  | %6d | %6d | %6d | %6d | %10d' % totals]
+    for i in range(payload[20]):
+        pid, *counts = struct.unpack_from('<6H', payload, 21 + 12 * i)
+        lines.append(' %4d | %6d | %6d | %6d | %6d | %10d' % (pid, *counts))
+    return '\n'.join(lines)
+
+
+def parse_profile(payload):
+    """(samples, dropped, hz, first, [(pc, pid, count)]) of one TLM_PROFILE frame."""
+    samples, dropped, hz, first, count = struct.unpack_from('<IIHBB', payload, 0)
+    slots = [struct.unpack_from('<IHH', payload, 12 + 8 * i) for i in range(count)]
+    return samples, dropped, hz, first, slots
+
+
+def format_profile(payload):
+    samples, dropped, hz, first, slots = parse_profile(payload)
+    lines = ['profile %d samples, %d dropped, %d Hz, entries %d-%d (tools/pcprofile.py names them)'
+             % (samples, dropped, hz, first, first + len(slots) - 1)]
+    lines += ['  0x%08X pid %3d %6d' % slot for slot in slots]
+    return '\n'.join(lines)
+
+
+def parse_trace(payload):
+    """(events, rate, first, [(count, word)]) of one TLM_TRACE frame, rate in
+    time base counts per microsecond."""
+    events, rate, count, first = struct.unpack_from('<IBBH', payload, 0)
+    records = [struct.unpack_from('<II', payload, 8 + 8 * i) for i in range(count)]
+    return events, rate, first, records
+
+
+def format_trace(payload):
+    events, rate, first, records = parse_trace(payload)
+    lines = ['trace %d events, %d counts/us, entries %d-%d (tools/trace2json.py converts them)'
+             % (events, rate, first, first + len(records) - 1)]
+    lines += ['  %10d type %2d arg 0x%06X' % (count, word >> 24, word & 0xFFFFFF) for count, word in records]
+    return '\n'.join(lines)
+
+
+def human_size(size):
+    for unit, div in (('GB', 1 << 30), ('MB', 1 << 20), ('KB', 1 << 10)):
+        if size >= div:
+            return '%d%s' % (size // div, unit)
+    return '%dB' % size
+
+
+class TelemetryReader:
+    """Byte at a time state machine, console bytes are written out as they arrive."""
+
+    def __init__(self, out, formats, raw=False):
+        self.out = out
+        self.formats = formats
+        self.raw = raw
+        self.frame = None
+        self.last_seq = None
+
+    def feed(self, byte):
+        if self.frame is None:
+            if byte == 0:
+                self.frame = bytearray()
+            else:
+                self.out.write(chr(byte))
+            return
+        if byte != 0:
+            self.frame.append(byte)
+            return
+        if not self.frame:
+            return                  # back to back delimiters, still waiting for a frame
+        try:
+            rtype, seq, payload = decode_frame(bytes(self.frame))
+        except ValueError:
+            # started mid-frame or lost bytes: what we collected was text and this
+            # zero opens the next frame
+            self.out.write(self.frame.decode('ascii', 'replace'))
+            self.frame = bytearray()
+            return
+        self.frame = None
+        self.emit(rtype, seq, payload)
+
+    def emit(self, rtype, seq, payload):
+        if self.last_seq is not None and seq != (self.last_seq + 1) & 0xFF:
+            self.out.write('\n[tlm] sequence gap %d -> %d\n' % (self.last_seq, seq))
+        self.last_seq = seq
+        if self.raw:
+            self.out.write('\n[tlm %3d] type %d %s\n' % (seq, rtype, payload.hex()))
+        elif rtype == TLM_LOG:
+            log_seq, text = logdecode.decode_log_payload(self.formats, payload)
+            self.out.write('\n[log %3d] %s\n' % (log_seq, text))
+        elif rtype == TLM_HEAP:
+            self.out.write('\n' + format_heap(payload) + '\n')
+        elif rtype == TLM_MPU:
+            self.out.write('\n' + format_mpu(payload) + '\n')
+        elif rtype == TLM_TASKS:
+            self.out.write('\n' + format_tasks(payload) + '\n')
+        elif rtype == TLM_FAULTS:
+            self.out.write('\n' + format_faults(payload) + '\n')
+        elif rtype == TLM_PROFILE:
+            self.out.write('\n' + format_profile(payload) + '\n')
+        elif rtype == TLM_TRACE:
+            self.out.write('\n' + format_trace(payload) + '\n')
+        else:
+            self.out.write('\n[tlm %3d] unknown type %d %s\n' % (seq, rtype, payload.hex()))
+
+
+def open_stream(path, baud):
+    if path == '-':
+        return sys.stdin.buffer
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        import termios
+        import tty
+        tty.setraw(fd)
+        attrs = termios.tcgetattr(fd)
+        speed = getattr(termios, 'B%d' % baud)
+        attrs[4] = attrs[5] = speed
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return os.fdopen(fd, 'rb', buffering=0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode telemetry frames and log records from the UART')
+    parser.add_argument('input', help='serial device, capture file or - for stdin')
+    parser.add_argument('--formats', default=logdecode.DEFAULT_FORMATS, help='path to logfmt.h')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--raw', action='store_true', help='print payloads as hex')
+    args = parser.parse_args()
+
+    reader = TelemetryReader(sys.stdout, logdecode.load_formats(args.formats), args.raw)
+    stream = open_stream(args.input, args.baud)
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        for byte in chunk:
+            reader.feed(byte)
+        sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+# Trace converter
+# Angelina Abuhilal
+#
+# Collects the TLM_TRACE frames of "tlm trace" from the UART stream (serial
+# port, capture file or stdin) and writes the kernel events as Chrome trace
+# JSON, which chrome://tracing and ui.perfetto.dev open. One track per pid
+# shows when it ran, its syscalls, mallocs and frees, a handler track shows
+# the interrupts. The last complete dump in the stream is converted.
+#
+#   python3 tools/trace2json.py /dev/ttyACM0 -o trace.json
+#   python3 tools/trace2json.py capture.bin -o trace.json --events
+
+import argparse
+import json
+import os
+import re
+import sys
+
+import telemetry
+
+DEFAULT_SYSCALLS = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'syscall.h')
+
+# TRACE_TYPE, trace.h
+SWITCH, ISR_ENTER, ISR_EXIT, SVC_ENTER, SVC_EXIT = 1, 2, 3, 4, 5
+MALLOC, MALLOC_DONE, FREE, FREE_DONE, BLOCK, WAKE, CLOCK = 6, 7, 8, 9, 10, 11, 12
+TRACE_NONE = 0xFFFFFF
+FRAME_EVENTS = 14
+WAIT_REASONS = {0: 'none', 1: 'sleep', 2: 'console', 3: 'button', 4: 'latency', 5: 'load'}
+HANDLER_TID = 0
+
+
+def load_syscalls(path=DEFAULT_SYSCALLS):
+    """SVC number -> name, the enum in syscall.h counts up from SVC_YIELD = 0."""
+    names = []
+    with open(path) as f:
+        text = f.read()
+    body = re.search(r'enum _SVC_NUMBER\s*\{(.*?)\}', text, re.S)
+    if body:
+        names = re.findall(r'^\s*(SVC_\w+)', body.group(1), re.M)
+    return {i: name[4:].lower() for i, name in enumerate(names)}
+
+
+def read_dumps(stream):
+    """Every complete dump: (events, rate, [(count, word)])."""
+    dumps, current, frame = [], None, None
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        for byte in chunk:
+            if byte != 0:
+                if frame is not None:
+                    frame.append(byte)
+                continue
+            if frame:
+                try:
+                    rtype, _, payload = telemetry.decode_frame(bytes(frame))
+                except ValueError:
+                    rtype = None
+                if rtype == telemetry.TLM_TRACE:
+                    events, rate, first, records = telemetry.parse_trace(payload)
+                    if first == 0:
+                        current = (events, rate, [])
+                    if current is not None and first == len(current[2]):
+                        current[2].extend(records)
+                        if len(records) < FRAME_EVENTS:     # a short frame ends the dump
+                            dumps.append(current)
+                            current = None
+            frame = bytearray()
+    return dumps
+
+
+def timestamps(rate, records):
+    """Microseconds of every record from the first one. The stamps are the low
+    word of the time base count, which keeps counting while the core sleeps
+    and wraps at 32 bits. It counts at the system clock: rate is counts per
+    microsecond at the end, each TRACE_CLOCK event gives the rate before it."""
+    rate = rate or 1
+    us = [0.0] * len(records)
+    for i in range(len(records) - 1, 0, -1):
+        count, word = records[i]
+        if word >> 24 == CLOCK:
+            rate = (word >> 8 & 0xFF) or rate
+        us[i] = ((count - records[i - 1][0]) & 0xFFFFFFFF) / rate
+    for i in range(1, len(us)):
+        us[i] += us[i - 1]
+    return us
+
+
+def exception_name(number):
+    if number == 15:
+        return 'SysTick'
+    return 'IRQ %d' % (number - 16)
+
+
+def convert(records, us, syscalls):
+    """Chrome trace events, all in process 1, tid = pid, handler on tid 0."""
+    out = []
+    pids = set()
+    open_slices = {}                    # tid -> names of B events not ended yet
+    running, since = None, 0.0
+
+    def begin(tid, name, ts, args=None):
+        out.append({'ph': 'B', 'pid': 1, 'tid': tid, 'name': name, 'ts': ts, 'args': args or {}})
+        open_slices.setdefault(tid, []).append(name)
+
+    def end(tid, ts, args=None):
+        # the ring may have lost the begin of the oldest slices
+        if open_slices.get(tid):
+            out.append({'ph': 'E', 'pid': 1, 'tid': tid, 'name': open_slices[tid].pop(), 'ts': ts,
+                        'args': args or {}})
+
+    def instant(tid, name, ts, args=None):
+        out.append({'ph': 'i', 's': 't', 'pid': 1, 'tid': tid, 'name': name, 'ts': ts, 'args': args or {}})
+
+    for (count, word), ts in zip(records, us):
+        kind, arg = word >> 24, word & 0xFFFFFF
+        tid = running if running is not None else HANDLER_TID
+        if kind == SWITCH:
+            if running is not None:
+                out.append({'ph': 'X', 'pid': 1, 'tid': running, 'name': 'run', 'ts': since, 'dur': ts - since})
+            running, since = arg, ts
+            pids.add(arg)
+        elif kind == ISR_ENTER:
+            begin(HANDLER_TID, exception_name(arg), ts)
+        elif kind == ISR_EXIT:
+            end(HANDLER_TID, ts)
+        elif kind == SVC_ENTER:
+            begin(tid, syscalls.get(arg, 'svc %d' % arg), ts)
+        elif kind == SVC_EXIT:
+            end(tid, ts)
+        elif kind == MALLOC:
+            begin(tid, 'malloc', ts, {'bytes': arg})
+        elif kind == MALLOC_DONE:
+            end(tid, ts, {'block': 'failed' if arg == TRACE_NONE else arg})
+        elif kind == FREE:
+            begin(tid, 'free', ts, {'block': arg})
+        elif kind == FREE_DONE:
+            end(tid, ts)
+        elif kind == BLOCK:
+            instant(tid, 'block ' + WAIT_REASONS.get(arg, str(arg)), ts)
+        elif kind == WAKE:
+            instant(arg, 'wake', ts)
+            pids.add(arg)
+        elif kind == CLOCK:
+            out.append({'ph': 'C', 'pid': 1, 'name': 'clock', 'ts': ts, 'args': {'MHz': arg & 0xFF}})
+        if tid != HANDLER_TID:
+            pids.add(tid)
+
+    last = us[-1] if us else 0.0
+    if running is not None:
+        out.append({'ph': 'X', 'pid': 1, 'tid': running, 'name': 'run', 'ts': since, 'dur': last - since})
+    for tid, names in open_slices.items():
+        while names:
+            end(tid, last)
+
+    meta = [{'ph': 'M', 'pid': 1, 'name': 'process_name', 'args': {'name': 'rtos'}},
+            {'ph': 'M', 'pid': 1, 'tid': HANDLER_TID, 'name': 'thread_name', 'args': {'name': 'handler'}}]
+    meta += [{'ph': 'M', 'pid': 1, 'tid': p, 'name': 'thread_name', 'args': {'name': 'pid %d' % p}}
+             for p in sorted(pids) if p != HANDLER_TID]
+    return meta + out
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Chrome trace JSON of a tlm trace dump')
+    parser.add_argument('input', help='serial device, capture file or - for stdin')
+    parser.add_argument('-o', '--output', default='-', help='JSON file, - for stdout')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--syscalls', default=DEFAULT_SYSCALLS, help='syscall.h to name the SVC numbers')
+    parser.add_argument('--events', action='store_true', help='also list the events on stderr')
+    args = parser.parse_args()
+
+    dumps = read_dumps(telemetry.open_stream(args.input, args.baud))
+    if not dumps:
+        sys.exit('no complete trace dump in %s, run "tlm trace" on the target' % args.input)
+    events, rate, records = dumps[-1]
+    us = timestamps(rate, records)
+
+    if args.events:
+        for (count, word), ts in zip(records, us):
+            sys.stderr.write('%12.3f us  type %2d arg 0x%06X\n' % (ts, word >> 24, word & 0xFFFFFF))
+    sys.stderr.write('%d events recorded, %d kept, %.1f us\n' % (events, len(records), us[-1] if us else 0))
+
+    trace = {'traceEvents': convert(records, us, load_syscalls(args.syscalls)), 'displayTimeUnit': 'ns'}
+    out = sys.stdout if args.output == '-' else open(args.output, 'w')
+    json.dump(trace, out, indent=0)
+    out.write('\n')
+
+
+if __name__ == '__main__':
+    main()
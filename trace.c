@@ -0,0 +1,79 @@
+// Trace Recorder Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// DWT:
+//   CYCCNT stamps every event, the trace points themselves are inline
+//   (trace.h), this file only starts, stops and reports the ring
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "isr.h"
+#include "uart0.h"
+#include "mem.h"
+#include "timebase.h"
+#include "trace.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+TRACE_RECORD *traceRing = NULL;
+volatile bool traceOn = false;
+uint32_t traceHead = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// an empty ring, the first event gives the rate the time base counts at.
+// False when the heap has no room for the ring
+bool traceStart(void)
+{
+#if TRACE
+    uint64_t srd = 0;
+    uint32_t rate = timeCyclesPerUs();
+
+    if (traceRing == NULL)
+        traceRing = malloc_heap_for(TRACE_EVENTS * sizeof(TRACE_RECORD), 0, &srd);
+    if (traceRing == NULL) return false;
+
+    traceOn = false;
+    traceHead = 0;
+    traceOn = true;
+    TRACE_POINT(TRACE_CLOCK, rate << 8 | rate);
+#endif
+    return true;
+}
+
+// the ring stays as it is for tlm trace
+void traceStop(void)
+{
+    traceOn = false;
+}
+
+void tracePrint(void)
+{
+    putsUart0("trace ");
+#if TRACE
+    putsUart0(traceOn ? "on, " : "off, ");
+    putsUart0(uitoa(traceHead));
+    putsUart0(" events, ");
+    putsUart0(uitoa(traceHead < TRACE_EVENTS ? traceHead : TRACE_EVENTS));
+    putsUart0(" kept");
+#else
+    putsUart0("compiled out (TRACE 0)");
+#endif
+}
@@ -0,0 +1,115 @@
+// Trace Recorder Library
+// Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Wide Timer 0:
+//   the low word of the time base count stamps every event (timebase.h),
+//   CMSDK Timer 0 under QEMU. Unlike CYCCNT it keeps counting in WFI
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * ==========================================================================
+ *               TRACE EVENT (ring of 8 byte events in the heap)
+ * ==========================================================================
+ *  word 0       time base count when it happened, low word
+ *  word 1       [31:24] TRACE_TYPE  [23:0] argument
+ *
+ *  TRACE_POINT() checks traceOn, masks interrupts and stores the two words,
+ *  inline, about 20 cycles. Built with -DTRACE=0 it is nothing at all.
+ *  The count runs at the system clock, so its rate changes with the clock
+ *  profile: TRACE_CLOCK records each change, the dump gives the rate at the end.
+ *  trace start takes the ring (kernel owned, like the profiler's table),
+ *  the ring keeps the newest TRACE_EVENTS events, trace stop freezes it and
+ *  tlm trace sends it as TLM_TRACE frames (telemetry.h) for
+ *  tools/trace2json.py, which writes Chrome trace JSON for Perfetto
+ *
+ *  only the kernel records: every trace point runs privileged
+ */
+
+#ifndef TRACE
+#define TRACE 1                         // 0 compiles every trace point out
+#endif
+
+#define TRACE_EVENTS    128             // power of 2
+#define TRACE_NONE      0xFFFFFF        // argument of a failed malloc
+
+// values match tools/trace2json.py
+typedef enum _TRACE_TYPE
+{
+    TRACE_SWITCH      = 1,              // pid switched in
+    TRACE_ISR_ENTER   = 2,              // exception number
+    TRACE_ISR_EXIT    = 3,
+    TRACE_SVC_ENTER   = 4,              // SVC_NUMBER (syscall.h)
+    TRACE_SVC_EXIT    = 5,
+    TRACE_MALLOC      = 6,              // bytes asked for
+    TRACE_MALLOC_DONE = 7,              // first block, TRACE_NONE when it failed
+    TRACE_FREE        = 8,              // first block
+    TRACE_FREE_DONE   = 9,
+    TRACE_BLOCK       = 10,             // WAIT_REASON (kernel.h) of the running task
+    TRACE_WAKE        = 11,             // pid made ready
+    TRACE_CLOCK       = 12              // time base counts per us, [15:8] before, [7:0] from here on
+} TRACE_TYPE;
+
+typedef struct _TRACE_RECORD
+{
+    uint32_t cycles;
+    uint32_t word;
+} TRACE_RECORD;
+
+extern TRACE_RECORD *traceRing;
+extern volatile bool traceOn;
+extern uint32_t traceHead;              // events ever recorded, the ring index is the low bits
+
+#if TRACE && !defined(HOST_SIM)
+#ifndef QEMU_MPS2
+#include "tm4c123gh6pm.h"
+#define TRACE_STAMP()   WTIMER0_TAV_R   // the time base's low word, one load
+#else
+#include "timebase.h"
+#define TRACE_STAMP()   timeCycles()    // Timer 0 there, always privileged here
+#endif
+
+static inline void traceRecord(uint32_t word)
+{
+    uint32_t primask = _disable_interrupts();
+    uint32_t head = traceHead;
+    TRACE_RECORD *r = &traceRing[head & (TRACE_EVENTS - 1)];
+
+    r->cycles = TRACE_STAMP();
+    r->word = word;
+    traceHead = head + 1;
+    _restore_interrupts(primask);
+}
+
+#define TRACE_POINT(type, arg) \
+    do { if (traceOn) traceRecord(((uint32_t)(type) << 24) | ((uint32_t)(arg) & 0xFFFFFF)); } while (0)
+#else
+#define TRACE_POINT(type, arg) do { } while (0)
+#endif
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool traceStart(void);
+void traceStop(void);
+void tracePrint(void);
+
+#endif
@@ -0,0 +1,331 @@
+// UART Library
+// Jason Losh, Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// UART Interface:
+//   any of UART0-UART7, described by a UART_DESC (pins listed in uart.h)
+//   tx and rx are buffered in RAM and moved to/from the 16-byte FIFOs by
+//   the UART interrupt
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "tm4c123gh6pm.h"
+#include "asm.h"
+#include "uart.h"
+#include "trace.h"
+
+// register offsets inside a UARTn block
+#define UART_DR     0x000
+#define UART_FR     0x018
+#define UART_IBRD   0x024
+#define UART_FBRD   0x028
+#define UART_LCRH   0x02C
+#define UART_CTL    0x030
+#define UART_IM     0x038
+#define UART_MIS    0x040
+#define UART_ICR    0x044
+#define UART_CC     0xFC8
+
+// register offsets inside a GPIO port block
+#define GPIO_AFSEL  0x420
+#define GPIO_DEN    0x51C
+#define GPIO_LOCK   0x520
+#define GPIO_CR     0x524
+#define GPIO_AMSEL  0x528
+#define GPIO_PCTL   0x52C
+
+#define UART_REG(uart, ofs) (*((volatile uint32_t *)((uart)->base + (ofs))))
+#define GPIO_REG(uart, ofs) (*((volatile uint32_t *)((uart)->gpioBase + (ofs))))
+
+#define TX_MASK (UART_TX_SIZE - 1)
+#define RX_MASK (UART_RX_SIZE - 1)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+//  base        gpio base   n  port tx rx pctl irq unlock
+const UART_DESC uarts[8] =
+{
+    {0x4000C000, 0x40004000, 0, 0,  1, 0, 1,   5, false},  // UART0 PA1/PA0
+    {0x4000D000, 0x40005000, 1, 1,  1, 0, 1,   6, false},  // UART1 PB1/PB0
+    {0x4000E000, 0x40007000, 2, 3,  7, 6, 1,  33, true },  // UART2 PD7/PD6, PD7 is locked
+    {0x4000F000, 0x40006000, 3, 2,  7, 6, 1,  59, false},  // UART3 PC7/PC6
+    {0x40010000, 0x40006000, 4, 2,  5, 4, 1,  60, false},  // UART4 PC5/PC4
+    {0x40011000, 0x40024000, 5, 4,  5, 4, 1,  61, false},  // UART5 PE5/PE4
+    {0x40012000, 0x40007000, 6, 3,  5, 4, 1,  62, false},  // UART6 PD5/PD4
+    {0x40013000, 0x40024000, 7, 4,  1, 0, 1,  63, false}   // UART7 PE1/PE0
+};
+
+// NULL until initUart, the driver falls back to polling the FIFO
+UART_STATE *uartState[8];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// moves queued bytes into the tx FIFO, tx interrupt stays on while bytes are left
+// caller masks interrupts (or is the uart isr)
+static void uartTxPump(const UART_DESC *uart, UART_STATE *s)
+{
+    while (s->txTail != s->txHead && !(UART_REG(uart, UART_FR) & UART_FR_TXFF))
+    {
+        UART_REG(uart, UART_DR) = s->txBuffer[s->txTail];
+        s->txTail = (s->txTail + 1) & TX_MASK;
+    }
+    if (s->txTail == s->txHead)
+        UART_REG(uart, UART_IM) &= ~UART_IM_TXIM;
+    else
+        UART_REG(uart, UART_IM) |= UART_IM_TXIM;
+}
+
+// Initialize UARTn pins and buffers, 115200 baud 8N1 assuming fcyc = 40 MHz
+// until setUartBaudRate is called with the real system clock
+void initUart(const UART_DESC *uart, UART_STATE *state)
+{
+    uint32_t pins = (1 << uart->txPin) | (1 << uart->rxPin);
+    uint32_t pctlMask = (0xF << (uart->txPin * 4)) | (0xF << (uart->rxPin * 4));
+    uint32_t pctl = (uart->pctl << (uart->txPin * 4)) | (uart->pctl << (uart->rxPin * 4));
+
+    // Enable clocks
+    SYSCTL_RCGCUART_R |= 1 << uart->number;
+    SYSCTL_RCGCGPIO_R |= 1 << uart->gpioPort;
+    _delay_cycles(3);
+
+    // Configure UART pins
+    if (uart->unlock)
+    {
+        GPIO_REG(uart, GPIO_LOCK) = GPIO_LOCK_KEY;
+        GPIO_REG(uart, GPIO_CR) |= pins;
+    }
+    GPIO_REG(uart, GPIO_AMSEL) &= ~pins;
+    GPIO_REG(uart, GPIO_DEN) |= pins;                   // enable digital on UART pins
+    GPIO_REG(uart, GPIO_AFSEL) |= pins;                 // use peripheral to drive the pins
+    GPIO_REG(uart, GPIO_PCTL) = (GPIO_REG(uart, GPIO_PCTL) & ~pctlMask) | pctl;
+
+    // Configure UART to 115200 baud (assuming fcyc = 40 MHz), 8N1 format
+    UART_REG(uart, UART_CTL) = 0;                       // turn-off UART to allow safe programming
+    UART_REG(uart, UART_CC) = UART_CC_CS_SYSCLK;        // use system clock (40 MHz)
+    UART_REG(uart, UART_IBRD) = 21;                     // r = 40 MHz / (Nx115.2kHz), set floor(r)=21, where N=16
+    UART_REG(uart, UART_FBRD) = 45;                     // round(fract(r)*64)=45
+    UART_REG(uart, UART_LCRH) = UART_LCRH_WLEN_8 | UART_LCRH_FEN;
+                                                        // configure for 8N1 w/ 16-level FIFO
+
+    // rx at half a FIFO or after 32 idle bits, tx when the FIFO drains to half
+    state->txHead = state->txTail = 0;
+    state->rxHead = state->rxTail = 0;
+    state->rxOverruns = 0;
+    state->rxSeen = false;
+    state->baudRate = 0;
+    uartState[uart->number] = state;
+    UART_REG(uart, UART_ICR) = 0x7F2;
+    UART_REG(uart, UART_IM) = UART_IM_RXIM | UART_IM_RTIM;
+    (&NVIC_EN0_R)[uart->irq >> 5] = 1 << (uart->irq & 31);
+
+    UART_REG(uart, UART_CTL) = UART_CTL_TXE | UART_CTL_RXE | UART_CTL_UARTEN;
+                                                        // enable TX, RX, and module
+}
+
+// Set baud rate as function of instruction cycle frequency. The divisors and
+// LCRH are only written with UARTEN clear, after the last byte left (BUSY),
+// as the datasheet asks. The UART is off for those three writes only
+void setUartBaudRate(const UART_DESC *uart, uint32_t baudRate, uint32_t fcyc)
+{
+    uint32_t ctl;
+    uint32_t divisorTimes128 = (fcyc * 8) / baudRate;   // calculate divisor (r) in units of 1/128,
+                                                        // where r = fcyc / 16 * baudRate
+    divisorTimes128 += 1;                               // add 1/128 to allow rounding
+    if (uartState[uart->number] != NULL)
+        uartState[uart->number]->baudRate = baudRate;
+    flushUart(uart);                                    // don't cut off bytes still in the FIFO, waits out BUSY
+    ctl = UART_REG(uart, UART_CTL);
+    UART_REG(uart, UART_CTL) = ctl & ~UART_CTL_UARTEN;  // turn-off UART to allow safe programming
+    UART_REG(uart, UART_IBRD) = divisorTimes128 >> 7;   // set integer value to floor(r)
+    UART_REG(uart, UART_FBRD) = ((divisorTimes128) >> 1) & 63;
+                                                        // set fractional value to round(fract(r)*64)
+    UART_REG(uart, UART_LCRH) = UART_LCRH_WLEN_8 | UART_LCRH_FEN;
+                                                        // configure for 8N1 w/ 16-level FIFO, latches the divisor
+    UART_REG(uart, UART_CTL) = ctl;                     // enabled again as it was
+}
+
+// Queues a character, blocking only while the tx buffer is full
+// works with interrupts masked (fault handlers), the FIFO is then fed by polling
+void putcUart(const UART_DESC *uart, char c)
+{
+    UART_STATE *s = uartState[uart->number];
+
+    if (s == NULL)
+    {
+        while (UART_REG(uart, UART_FR) & UART_FR_TXFF); // wait if tx fifo full
+        UART_REG(uart, UART_DR) = c;                    // write character to fifo
+        return;
+    }
+
+    while (true)
+    {
+        uint32_t primask = enterCritical();
+        uint8_t next = (s->txHead + 1) & TX_MASK;
+        if (next != s->txTail)
+        {
+            s->txBuffer[s->txHead] = c;
+            s->txHead = next;
+            uartTxPump(uart, s);                        // straight to the FIFO if it has room
+            leaveCritical(primask);
+            return;
+        }
+        uartTxPump(uart, s);                            // buffer full, make room
+        leaveCritical(primask);
+    }
+}
+
+// Blocking function that writes a string when the UART buffer is not full
+void putsUart(const UART_DESC *uart, const char *str)
+{
+    while (*str != '\0')
+        putcUart(uart, *str++);
+}
+
+// binary safe version of putsUart
+void writeUart(const UART_DESC *uart, const uint8_t *data, uint32_t length)
+{
+    while (length--)
+        putcUart(uart, *data++);
+}
+
+// Blocking function that returns with serial data once the buffer is not empty
+char getcUart(const UART_DESC *uart)
+{
+    UART_STATE *s = uartState[uart->number];
+    char c;
+
+    if (s == NULL)
+    {
+        while (UART_REG(uart, UART_FR) & UART_FR_RXFE); // wait if rx fifo empty
+        return UART_REG(uart, UART_DR) & 0xFF;          // get character from fifo, masking off the flags
+    }
+
+    while (s->rxHead == s->rxTail);
+    c = s->rxBuffer[s->rxTail];
+    s->rxTail = (s->rxTail + 1) & RX_MASK;
+    return c;
+}
+
+// Returns the status of the receive buffer
+bool kbhitUart(const UART_DESC *uart)
+{
+    UART_STATE *s = uartState[uart->number];
+
+    if (s == NULL)
+        return !(UART_REG(uart, UART_FR) & UART_FR_RXFE);
+    return s->rxHead != s->rxTail;
+}
+
+// Waits until every queued byte has left the shift register
+void flushUart(const UART_DESC *uart)
+{
+    UART_STATE *s = uartState[uart->number];
+
+    while (s != NULL && s->txTail != s->txHead)
+    {
+        uint32_t primask = enterCritical();
+        uartTxPump(uart, s);
+        leaveCritical(primask);
+    }
+    while (UART_REG(uart, UART_FR) & UART_FR_BUSY);
+}
+
+// sends what is queued, then masks the UART and forgets its state, so the
+// state can be handed to another port
+void closeUart(const UART_DESC *uart)
+{
+    if (uartState[uart->number] == NULL) return;
+    flushUart(uart);
+    (&NVIC_DIS0_R)[uart->irq >> 5] = 1 << (uart->irq & 31);
+    UART_REG(uart, UART_IM) = 0;
+    UART_REG(uart, UART_CTL) = 0;
+    uartState[uart->number] = NULL;
+}
+
+// every open UART, before the system clock changes
+void flushUarts(void)
+{
+    uint8_t n;
+    for (n = 0; n < 8; n++)
+        if (uartState[n] != NULL)
+            flushUart(&uarts[n]);
+}
+
+// true when no open UART has a byte queued or still on the wire, has a byte
+// waiting in the rx FIFO or took one since the last call. The receiver has
+// no busy flag, a line quiet since the last governor window stands in for it
+bool uartsIdle(void)
+{
+    uint8_t n;
+    bool idle = true;
+    for (n = 0; n < 8; n++)
+    {
+        if (uartState[n] == NULL) continue;
+        if (uartState[n]->txTail != uartState[n]->txHead || uartState[n]->rxSeen
+         || (UART_REG(&uarts[n], UART_FR) & (UART_FR_BUSY | UART_FR_RXFE)) != UART_FR_RXFE)
+            idle = false;
+        uartState[n]->rxSeen = false;
+    }
+    return idle;
+}
+
+// after the system clock changed, every open UART gets its baud rate back
+void setUartsClock(uint32_t fcyc)
+{
+    uint8_t n;
+    for (n = 0; n < 8; n++)
+        if (uartState[n] != NULL && uartState[n]->baudRate)
+            setUartBaudRate(&uarts[n], uartState[n]->baudRate, fcyc);
+}
+
+// drains the rx FIFO into the buffer and refills the tx FIFO
+static void uartIsr(const UART_DESC *uart)
+{
+    UART_STATE *s = uartState[uart->number];
+    uint32_t mis = UART_REG(uart, UART_MIS);
+
+    TRACE_POINT(TRACE_ISR_ENTER, uart->irq + 16);
+    UART_REG(uart, UART_ICR) = mis;
+    while (!(UART_REG(uart, UART_FR) & UART_FR_RXFE))
+    {
+        uint8_t c = UART_REG(uart, UART_DR) & 0xFF;
+        uint8_t next = (s->rxHead + 1) & RX_MASK;
+        if (next != s->rxTail)
+        {
+            s->rxBuffer[s->rxHead] = c;
+            s->rxHead = next;
+        }
+        else
+            s->rxOverruns++;
+        s->rxSeen = true;
+    }
+    if (mis & UART_MIS_TXMIS)
+        uartTxPump(uart, s);
+    TRACE_POINT(TRACE_ISR_EXIT, uart->irq + 16);
+}
+
+void uart0Isr(void) { uartIsr(&uarts[0]); }
+void uart1Isr(void) { uartIsr(&uarts[1]); }
+void uart2Isr(void) { uartIsr(&uarts[2]); }
+void uart3Isr(void) { uartIsr(&uarts[3]); }
+void uart4Isr(void) { uartIsr(&uarts[4]); }
+void uart5Isr(void) { uartIsr(&uarts[5]); }
+void uart6Isr(void) { uartIsr(&uarts[6]); }
+void uart7Isr(void) { uartIsr(&uarts[7]); }
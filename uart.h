@@ -0,0 +1,87 @@
+// UART Library
+// Jason Losh, Angelina Abuhilal
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// UART Interface:
+//   UART0 PA1/PA0  UART1 PB1/PB0  UART2 PD7/PD6  UART3 PC7/PC6   (TX/RX)
+//   UART4 PC5/PC4  UART5 PE5/PE4  UART6 PD5/PD4  UART7 PE1/PE0
+//   UART0 is routed to the ICDI virtual COM port on the EK-TM4C123GXL
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef UART_H_
+#define UART_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UART_TX_SIZE 128        // power of 2
+#define UART_RX_SIZE 32         // power of 2
+
+// everything the driver needs to know about one UART, lives in flash
+typedef struct _UART_DESC
+{
+    uint32_t base;              // UARTn register block
+    uint32_t gpioBase;          // APB GPIO port register block of the pins
+    uint8_t  number;            // n, also the RCGCUART bit
+    uint8_t  gpioPort;          // RCGCGPIO bit of the port (A = 0)
+    uint8_t  txPin;
+    uint8_t  rxPin;
+    uint8_t  pctl;              // PCTL function number of both pins
+    uint8_t  irq;               // NVIC interrupt number
+    bool     unlock;            // a pin is behind the GPIO commit lock (PD7)
+} UART_DESC;
+
+// RAM side of an open UART, owned by whoever opens it
+typedef struct _UART_STATE
+{
+    uint8_t txBuffer[UART_TX_SIZE];
+    uint8_t rxBuffer[UART_RX_SIZE];
+    volatile uint8_t txHead;    // written by putcUart
+    volatile uint8_t txTail;    // written by the tx pump
+    volatile uint8_t rxHead;    // written by the isr
+    volatile uint8_t rxTail;    // written by getcUart
+    volatile bool rxSeen;       // the isr took a byte since uartsIdle last looked
+    uint32_t rxOverruns;
+    uint32_t baudRate;          // last setUartBaudRate, for setUartsClock
+} UART_STATE;
+
+extern const UART_DESC uarts[8];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initUart(const UART_DESC *uart, UART_STATE *state);
+void setUartBaudRate(const UART_DESC *uart, uint32_t baudRate, uint32_t fcyc);
+void putcUart(const UART_DESC *uart, char c);
+void putsUart(const UART_DESC *uart, const char *str);
+void writeUart(const UART_DESC *uart, const uint8_t *data, uint32_t length);
+char getcUart(const UART_DESC *uart);
+bool kbhitUart(const UART_DESC *uart);
+void flushUart(const UART_DESC *uart);
+void closeUart(const UART_DESC *uart);
+void flushUarts(void);
+bool uartsIdle(void);
+void setUartsClock(uint32_t fcyc);
+
+void uart0Isr(void);
+void uart1Isr(void);
+void uart2Isr(void);
+void uart3Isr(void);
+void uart4Isr(void);
+void uart5Isr(void);
+void uart6Isr(void);
+void uart7Isr(void);
+
+#endif